@@ -0,0 +1,561 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs a fixed set of seeded scenarios through the simulation (no rendering,
+// no controllers) and reports how long the ticks took, as JSON.  Optionally
+// compares the results against a previous run and fails if anything got
+// slower by more than a threshold.
+//
+// NOTE: No baseline is checked in, because tick times only mean anything on
+// the machine that measured them.  To make one, run on the machine that will
+// do the checking with --out <file>, then pass that file to --baseline on
+// later runs.  Every scenario and scaling point that runs has to be in the
+// baseline.  Anything missing fails the run, so that a gap doesn't pass for
+// "no regression".
+//
+// Each scenario is run twice from the same seed: once untouched, for the 
+// tick times, and once with SimStats turned on, for the per-phase breakdown.
+// That way the cost of timing the phases doesn't leak into the tick times.
+//
+// Built with CRASHLOYAL_ALLOC_TRACKING, the second pass also counts heap
+// allocations, and --max-allocs turns "steady state ticks don't allocate"
+// into something that can fail the run.
+
+#include "BenchmarkScenarios.h"
+
+#include "AllocTracker.h"
+#include "Constants.h"
+#include "Game.h"
+#include "JobSystem.h"
+#include "SimStats.h"
+#include "SpatialKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Entities log every attack to cout, which would swamp the timings (and
+    // the terminal).  While a scenario runs, cout goes here instead.
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        virtual int overflow(int c) { return c; }
+    };
+
+    struct Options
+    {
+        Options()
+            : m_NumTicks(300)
+            , m_NumWarmupTicks(20)
+            , m_Seed(12345)
+            , m_pOnlyScenario(NULL)
+            , m_pOutPath(NULL)
+            , m_pBaselinePath(NULL)
+            , m_Threshold(0.1f)
+            , m_MaxAllocsPerTick(-1)
+            , m_NumThreads(0)
+        {
+            static const int kDefaultScaling[] = { 10, 25, 50, 100, 200, 400 };
+            m_ScalingUnits.assign(kDefaultScaling, kDefaultScaling + 6);
+        }
+
+        int m_NumTicks;
+        int m_NumWarmupTicks;
+        unsigned int m_Seed;
+        std::vector<int> m_ScalingUnits;    // empty => no scaling curves
+        const char* m_pOnlyScenario;        // NULL => all of them
+        const char* m_pOutPath;             // NULL => stdout
+        const char* m_pBaselinePath;        // NULL => no comparison
+        float m_Threshold;                  // fractional slowdown that counts as a regression
+        int64_t m_MaxAllocsPerTick;         // -1 => no limit
+        unsigned int m_NumThreads;          // 0 => one per core
+    };
+
+    struct TickStats
+    {
+        double m_Mean;
+        double m_P50;
+        double m_P90;
+        double m_P99;
+        double m_Max;
+    };
+
+    struct RunResult
+    {
+        std::string m_Name;
+        int m_NumUnits;
+        TickStats m_TickMs;
+        uint64_t m_PhaseNs[SimStats::NumPhases];
+        uint64_t m_PhaseCalls[SimStats::NumPhases];
+        uint64_t m_Counts[SimStats::NumCounters];
+        uint64_t m_Allocations;
+        uint64_t m_MaxTickAllocations;
+    };
+
+    struct Comparison
+    {
+        std::string m_Name;
+        int m_NumUnits;
+        const char* m_Metric;
+        double m_Baseline;
+        double m_Current;
+        bool m_bRegressed;
+    };
+
+    void printUsage()
+    {
+        fprintf(stderr, "Usage: Benchmark [options]\n");
+        fprintf(stderr, "  --ticks <n>          ticks to time per run (default 300)\n");
+        fprintf(stderr, "  --warmup <n>         ticks to run before timing starts (default 20)\n");
+        fprintf(stderr, "  --seed <n>           seed for every scenario (default 12345)\n");
+        fprintf(stderr, "  --scenario <name>    only run the named scenario\n");
+        fprintf(stderr, "  --scaling <n,n,...>  unit counts for the scaling curves (default 10,25,50,100,200,400)\n");
+        fprintf(stderr, "  --no-scaling         skip the scaling curves\n");
+        fprintf(stderr, "  --out <file>         write the JSON here instead of stdout\n");
+        fprintf(stderr, "  --baseline <file>    compare against the JSON from an earlier --out on this machine\n");
+        fprintf(stderr, "  --threshold <f>      slowdown that counts as a regression (default 0.1 = 10%%)\n");
+        fprintf(stderr, "  --max-allocs <n>     fail if any timed tick allocates more than this (needs CRASHLOYAL_ALLOC_TRACKING)\n");
+        fprintf(stderr, "  --threads <n>        threads for the decide phase of each tick (default 0 = one per core)\n");
+    }
+
+    bool parseArgs(int argc, char* args[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* arg = args[i];
+            const char* value = (i + 1 < argc) ? args[i + 1] : NULL;
+
+            if (!strcmp(arg, "--no-scaling"))
+            {
+                options.m_ScalingUnits.clear();
+                continue;
+            }
+
+            if (!value)
+            {
+                printUsage();
+                return false;
+            }
+
+            if (!strcmp(arg, "--ticks"))
+                options.m_NumTicks = std::max(1, atoi(value));
+            else if (!strcmp(arg, "--warmup"))
+                options.m_NumWarmupTicks = std::max(0, atoi(value));
+            else if (!strcmp(arg, "--seed"))
+                options.m_Seed = (unsigned int)strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "--scenario"))
+                options.m_pOnlyScenario = value;
+            else if (!strcmp(arg, "--out"))
+                options.m_pOutPath = value;
+            else if (!strcmp(arg, "--baseline"))
+                options.m_pBaselinePath = value;
+            else if (!strcmp(arg, "--threshold"))
+                options.m_Threshold = (float)atof(value);
+            else if (!strcmp(arg, "--max-allocs"))
+                options.m_MaxAllocsPerTick = std::max(0, atoi(value));
+            else if (!strcmp(arg, "--threads"))
+                options.m_NumThreads = (unsigned int)std::max(0, atoi(value));
+            else if (!strcmp(arg, "--scaling"))
+            {
+                options.m_ScalingUnits.clear();
+                for (const char* p = value; *p; )
+                {
+                    options.m_ScalingUnits.push_back(atoi(p));
+                    const char* pComma = strchr(p, ',');
+                    p = pComma ? pComma + 1 : p + strlen(p);
+                }
+            }
+            else
+            {
+                printUsage();
+                return false;
+            }
+            ++i;
+        }
+
+        return true;
+    }
+
+    // Nearest-rank percentile.  The samples must already be sorted.
+    double percentile(const std::vector<double>& sorted, double pct)
+    {
+        size_t rank = (size_t)(pct / 100.0 * (double)sorted.size() + 0.5);
+        rank = std::min(std::max(rank, (size_t)1), sorted.size());
+        return sorted[rank - 1];
+    }
+
+    TickStats summarize(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+
+        double total = 0.0;
+        for (double s : samples)
+            total += s;
+
+        TickStats stats;
+        stats.m_Mean = total / (double)samples.size();
+        stats.m_P50 = percentile(samples, 50.0);
+        stats.m_P90 = percentile(samples, 90.0);
+        stats.m_P99 = percentile(samples, 99.0);
+        stats.m_Max = samples.back();
+        return stats;
+    }
+
+    void setUpScenario(const BenchmarkScenario& scenario, int numUnits, const Options& options)
+    {
+        Game& game = Game::get();
+        game.startMatch(NULL, NULL);
+
+        std::mt19937 rng(options.m_Seed);
+        scenario.m_pSetup(rng, numUnits);
+
+        for (int i = 0; i < options.m_NumWarmupTicks; ++i)
+            game.tick(TICK_MIN);
+    }
+
+    RunResult runScenario(const BenchmarkScenario& scenario, int numUnits, const Options& options)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        Game& game = Game::get();
+        SimStats& simStats = SimStats::get();
+
+        RunResult result;
+        result.m_Name = scenario.m_Name;
+        result.m_NumUnits = numUnits;
+
+        // Pass 1: tick times, with nothing else going on
+        simStats.setEnabled(false);
+        setUpScenario(scenario, numUnits, options);
+
+        std::vector<double> tickMs;
+        tickMs.reserve(options.m_NumTicks);
+        for (int i = 0; i < options.m_NumTicks; ++i)
+        {
+            Clock::time_point start = Clock::now();
+            game.tick(TICK_MIN);
+            tickMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        result.m_TickMs = summarize(tickMs);
+
+        // Pass 2: the same ticks again, with the phases timed
+        setUpScenario(scenario, numUnits, options);
+        simStats.reset();
+        simStats.setEnabled(true);
+        result.m_Allocations = 0;
+        result.m_MaxTickAllocations = 0;
+        for (int i = 0; i < options.m_NumTicks; ++i)
+        {
+            game.tick(TICK_MIN);
+
+            int64_t allocations = std::max((int64_t)0, game.getLastTickStats().m_Allocations);
+            result.m_Allocations += allocations;
+            result.m_MaxTickAllocations = std::max(result.m_MaxTickAllocations, (uint64_t)allocations);
+        }
+        simStats.setEnabled(false);
+
+        for (int i = 0; i < SimStats::NumPhases; ++i)
+        {
+            result.m_PhaseNs[i] = simStats.getTotalNs((SimStats::Phase)i);
+            result.m_PhaseCalls[i] = simStats.getNumCalls((SimStats::Phase)i);
+        }
+
+        for (int i = 0; i < SimStats::NumCounters; ++i)
+        {
+            result.m_Counts[i] = simStats.getCount((SimStats::Counter)i);
+        }
+
+        return result;
+    }
+
+    // Every result goes on a line of its own, which is what lets
+    // loadBaseline() get away with reading it back a line at a time.
+    void writeResult(FILE* pFile, const RunResult& r, int numTicks, bool bWithPhases, bool bLast)
+    {
+        fprintf(pFile, "    {\"name\": \"%s\", \"units\": %d, \"tick_ms\": {\"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+            r.m_Name.c_str(), r.m_NumUnits, r.m_TickMs.m_Mean, r.m_TickMs.m_P50, r.m_TickMs.m_P90, r.m_TickMs.m_P99, r.m_TickMs.m_Max);
+
+        if (bWithPhases)
+        {
+            fprintf(pFile, ", \"phases\": {");
+            for (int i = 0; i < SimStats::NumPhases; ++i)
+            {
+                uint64_t calls = r.m_PhaseCalls[i];
+                fprintf(pFile, "%s\"%s\": {\"calls\": %llu, \"total_ms\": %.4f, \"ns_per_call\": %.1f}",
+                    (i > 0) ? ", " : "",
+                    SimStats::getPhaseName((SimStats::Phase)i),
+                    (unsigned long long)calls,
+                    (double)r.m_PhaseNs[i] / 1.0e6,
+                    calls ? (double)r.m_PhaseNs[i] / (double)calls : 0.0);
+            }
+            fprintf(pFile, "}");
+
+            fprintf(pFile, ", \"per_tick\": {");
+            for (int i = 0; i < SimStats::NumCounters; ++i)
+            {
+                fprintf(pFile, "%s\"%s\": %.1f",
+                    (i > 0) ? ", " : "",
+                    SimStats::getCounterName((SimStats::Counter)i),
+                    (double)r.m_Counts[i] / (double)numTicks);
+            }
+            if (AllocTracker::isCompiledIn())
+            {
+                fprintf(pFile, ", \"allocations\": %.1f, \"max_allocations\": %llu",
+                    (double)r.m_Allocations / (double)numTicks,
+                    (unsigned long long)r.m_MaxTickAllocations);
+            }
+            fprintf(pFile, "}");
+        }
+
+        fprintf(pFile, "}%s\n", bLast ? "" : ",");
+    }
+
+    bool readNumber(const std::string& line, const char* key, double& value)
+    {
+        size_t pos = line.find(key);
+        if (pos == std::string::npos)
+            return false;
+
+        value = atof(line.c_str() + pos + strlen(key));
+        return true;
+    }
+
+    // Reads back the scenario and scaling results from an earlier run's JSON.
+    // This isn't a general JSON parser - it only understands what we write.
+    bool loadBaseline(const char* pPath, std::vector<RunResult>& results)
+    {
+        FILE* pFile = fopen(pPath, "r");
+        if (!pFile)
+        {
+            fprintf(stderr, "Couldn't open baseline %s\n", pPath);
+            return false;
+        }
+
+        char buffer[4096];
+        while (fgets(buffer, sizeof(buffer), pFile))
+        {
+            std::string line(buffer);
+            const char* kNameKey = "{\"name\": \"";
+            size_t namePos = line.find(kNameKey);
+            if (namePos == std::string::npos)
+                continue;
+
+            namePos += strlen(kNameKey);
+            size_t nameEnd = line.find('"', namePos);
+
+            RunResult r;
+            r.m_Name = line.substr(namePos, nameEnd - namePos);
+
+            double units = 0.0;
+            if (readNumber(line, "\"units\": ", units) &&
+                readNumber(line, "\"p50\": ", r.m_TickMs.m_P50) &&
+                readNumber(line, "\"p99\": ", r.m_TickMs.m_P99))
+            {
+                r.m_NumUnits = (int)units;
+                results.push_back(r);
+            }
+        }
+
+        fclose(pFile);
+        return true;
+    }
+
+    // Anything in current that the baseline has no entry for goes in missing
+    void compare(const std::vector<RunResult>& current, const std::vector<RunResult>& baseline,
+                 float threshold, std::vector<Comparison>& comparisons, std::vector<const RunResult*>& missing)
+    {
+        for (const RunResult& cur : current)
+        {
+            bool bFound = false;
+            for (const RunResult& base : baseline)
+            {
+                if ((base.m_Name != cur.m_Name) || (base.m_NumUnits != cur.m_NumUnits))
+                    continue;
+
+                Comparison c = { cur.m_Name, cur.m_NumUnits, "p50", base.m_TickMs.m_P50, cur.m_TickMs.m_P50, false };
+                c.m_bRegressed = c.m_Current > c.m_Baseline * (1.0 + threshold);
+                comparisons.push_back(c);
+
+                c.m_Metric = "p99";
+                c.m_Baseline = base.m_TickMs.m_P99;
+                c.m_Current = cur.m_TickMs.m_P99;
+                c.m_bRegressed = c.m_Current > c.m_Baseline * (1.0 + threshold);
+                comparisons.push_back(c);
+                bFound = true;
+                break;
+            }
+
+            if (!bFound)
+                missing.push_back(&cur);
+        }
+    }
+}
+
+int main(int argc, char* args[])
+{
+    Options options;
+    if (!parseArgs(argc, args, options))
+        return 1;
+
+    if ((options.m_MaxAllocsPerTick >= 0) && !AllocTracker::isCompiledIn())
+    {
+        fprintf(stderr, "--max-allocs needs a build with CRASHLOYAL_ALLOC_TRACKING\n");
+        return 1;
+    }
+
+    // Build the game (and the singletons it uses) before silencing cout
+    Game::get();
+    SimStats::get();
+    JobSystem::get().setNumThreads(options.m_NumThreads);
+
+    NullBuffer nullBuffer;
+    std::streambuf* pCoutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    std::vector<RunResult> scenarioResults;
+    std::vector<RunResult> scalingResults;
+
+    for (const BenchmarkScenario& scenario : getBenchmarkScenarios())
+    {
+        if (options.m_pOnlyScenario && strcmp(options.m_pOnlyScenario, scenario.m_Name))
+            continue;
+
+        fprintf(stderr, "%s (%d units)\n", scenario.m_Name, scenario.m_NumUnits);
+        scenarioResults.push_back(runScenario(scenario, scenario.m_NumUnits, options));
+
+        if (!scenario.m_bScales)
+            continue;
+
+        for (int numUnits : options.m_ScalingUnits)
+        {
+            fprintf(stderr, "%s scaling (%d units)\n", scenario.m_Name, numUnits);
+            scalingResults.push_back(runScenario(scenario, numUnits, options));
+        }
+    }
+
+    // Put the last match away while cout is still going nowhere
+    Game::get().startMatch(NULL, NULL);
+    std::cout.rdbuf(pCoutBuffer);
+
+    std::vector<RunResult> current = scenarioResults;
+    current.insert(current.end(), scalingResults.begin(), scalingResults.end());
+
+    std::vector<Comparison> comparisons;
+    std::vector<const RunResult*> missing;
+    if (options.m_pBaselinePath)
+    {
+        std::vector<RunResult> baseline;
+        if (!loadBaseline(options.m_pBaselinePath, baseline))
+            return 1;
+
+        compare(current, baseline, options.m_Threshold, comparisons, missing);
+    }
+
+    FILE* pFile = options.m_pOutPath ? fopen(options.m_pOutPath, "w") : stdout;
+    if (!pFile)
+    {
+        fprintf(stderr, "Couldn't open %s for writing\n", options.m_pOutPath);
+        return 1;
+    }
+
+    fprintf(pFile, "{\n");
+    fprintf(pFile, "  \"ticks\": %d,\n  \"warmup_ticks\": %d,\n  \"seed\": %u,\n  \"tick_sec\": %.3f,\n  \"simd\": \"%s\",\n  \"threads\": %u,\n",
+        options.m_NumTicks, options.m_NumWarmupTicks, options.m_Seed, TICK_MIN, SpatialKernels::getInstructionSet(),
+        JobSystem::get().getNumThreads());
+
+    fprintf(pFile, "  \"scenarios\": [\n");
+    for (size_t i = 0; i < scenarioResults.size(); ++i)
+        writeResult(pFile, scenarioResults[i], options.m_NumTicks, true, i + 1 == scenarioResults.size());
+    fprintf(pFile, "  ],\n");
+
+    fprintf(pFile, "  \"scaling\": [\n");
+    for (size_t i = 0; i < scalingResults.size(); ++i)
+        writeResult(pFile, scalingResults[i], options.m_NumTicks, false, i + 1 == scalingResults.size());
+    fprintf(pFile, "  ]");
+
+    int numRegressions = 0;
+    if (options.m_pBaselinePath)
+    {
+        fprintf(pFile, ",\n  \"comparison\": {\"baseline\": \"%s\", \"threshold\": %.3f, \"results\": [\n",
+            options.m_pBaselinePath, options.m_Threshold);
+        for (size_t i = 0; i < comparisons.size(); ++i)
+        {
+            const Comparison& c = comparisons[i];
+            fprintf(pFile, "    {\"name\": \"%s\", \"units\": %d, \"metric\": \"%s\", \"baseline_ms\": %.4f, \"current_ms\": %.4f, \"change\": %.3f, \"regressed\": %s}%s\n",
+                c.m_Name.c_str(), c.m_NumUnits, c.m_Metric, c.m_Baseline, c.m_Current,
+                (c.m_Baseline > 0.0) ? (c.m_Current / c.m_Baseline) - 1.0 : 0.0,
+                c.m_bRegressed ? "true" : "false",
+                (i + 1 == comparisons.size()) ? "" : ",");
+
+            if (c.m_bRegressed)
+            {
+                ++numRegressions;
+                fprintf(stderr, "REGRESSION: %s (%d units) %s %.4f ms -> %.4f ms\n",
+                    c.m_Name.c_str(), c.m_NumUnits, c.m_Metric, c.m_Baseline, c.m_Current);
+            }
+        }
+        fprintf(pFile, "  ], \"missing\": [\n");
+        for (size_t i = 0; i < missing.size(); ++i)
+        {
+            const RunResult& r = *missing[i];
+            fprintf(pFile, "    {\"name\": \"%s\", \"units\": %d}%s\n",
+                r.m_Name.c_str(), r.m_NumUnits, (i + 1 == missing.size()) ? "" : ",");
+            fprintf(stderr, "MISSING: %s (%d units) has no baseline entry\n", r.m_Name.c_str(), r.m_NumUnits);
+        }
+        fprintf(pFile, "  ]}");
+    }
+    fprintf(pFile, "\n}\n");
+
+    if (pFile != stdout)
+        fclose(pFile);
+
+    int numOverAllocated = 0;
+    if (options.m_MaxAllocsPerTick >= 0)
+    {
+        for (const RunResult& r : scenarioResults)
+        {
+            if ((int64_t)r.m_MaxTickAllocations > options.m_MaxAllocsPerTick)
+            {
+                ++numOverAllocated;
+                fprintf(stderr, "ALLOCATIONS: %s (%d units) allocated %llu times in one tick (limit %lld)\n",
+                    r.m_Name.c_str(), r.m_NumUnits, (unsigned long long)r.m_MaxTickAllocations,
+                    (long long)options.m_MaxAllocsPerTick);
+            }
+        }
+    }
+
+    if (AllocTracker::isCompiledIn())
+        AllocTracker::writeReport(stderr);
+
+    if (options.m_pBaselinePath)
+        fprintf(stderr, "%d of %d comparisons regressed by more than %.0f%%, %d of %d runs had no baseline\n",
+            numRegressions, (int)comparisons.size(), options.m_Threshold * 100.f,
+            (int)missing.size(), (int)current.size());
+
+    return ((numRegressions > 0) || (numOverAllocated > 0) || !missing.empty()) ? 2 : 0;
+}
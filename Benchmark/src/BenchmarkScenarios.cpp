@@ -0,0 +1,135 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BenchmarkScenarios.h"
+
+#include "Constants.h"
+#include "EntityStats.h"
+#include "Game.h"
+#include "Player.h"
+
+namespace
+{
+    float randomFloat(std::mt19937& rng, float min, float max)
+    {
+        std::uniform_real_distribution<float> dist(min, max);
+        return dist(rng);
+    }
+
+    iEntityStats::MobType randomType(std::mt19937& rng, const iEntityStats::MobType* pTypes, int numTypes)
+    {
+        std::uniform_int_distribution<int> dist(0, numTypes - 1);
+        return pTypes[dist(rng)];
+    }
+
+    // Mirrors a position on the North half of the board onto the South half
+    Vec2 toSide(const Vec2& northPos, bool bNorth)
+    {
+        return bNorth ? northPos : Vec2(northPos.x, (float)GAME_GRID_HEIGHT - northPos.y);
+    }
+
+    void setupEmpty(std::mt19937& /*rng*/, int /*numUnits*/)
+    {
+        // Just the towers, so there's nothing to seed or size
+    }
+
+    // Both sides crowd toward the bridges, so the fighting (and the collision
+    // checks) all happen in two small areas.
+    void setupBridgeBrawl(std::mt19937& rng, int numUnits)
+    {
+        static const iEntityStats::MobType kTypes[] =
+            { iEntityStats::Swordsman, iEntityStats::Archer, iEntityStats::Giant };
+
+        for (int i = 0; i < numUnits; ++i)
+        {
+            bool bNorth = (i % 2) == 0;
+            float bridgeX = ((i / 2) % 2 == 0) ? LEFT_BRIDGE_CENTER_X : RIGHT_BRIDGE_CENTER_X;
+            Vec2 northPos(bridgeX + randomFloat(rng, -1.5f, 1.5f), RIVER_TOP_Y - randomFloat(rng, 0.5f, 3.f));
+
+            Game::get().getPlayer(bNorth).spawnMob(randomType(rng, kTypes, 3), toSide(northPos, bNorth));
+        }
+    }
+
+    // Every type of unit, scattered over each side's half of the board
+    void setupMixed(std::mt19937& rng, int numUnits)
+    {
+        static const iEntityStats::MobType kTypes[] =
+            { iEntityStats::Swordsman, iEntityStats::Archer, iEntityStats::Giant, iEntityStats::Rogue };
+
+        for (int i = 0; i < numUnits; ++i)
+        {
+            bool bNorth = (i % 2) == 0;
+            Vec2 northPos(randomFloat(rng, 0.5f, GAME_GRID_WIDTH - 0.5f), randomFloat(rng, 0.5f, RIVER_TOP_Y - 0.5f));
+
+            Game::get().getPlayer(bNorth).spawnMob(randomType(rng, kTypes, 4), toSide(northPos, bNorth));
+        }
+    }
+
+    // Half of each side are Rogues, spread around their own princess towers
+    // alongside some Giants, with the rest of the units up at the river where
+    // they can see them.  This keeps isHidden() busy.
+    void setupRogueHide(std::mt19937& rng, int numUnits)
+    {
+        static const iEntityStats::MobType kCover[] = { iEntityStats::Giant };
+        static const iEntityStats::MobType kAttackers[] = { iEntityStats::Swordsman, iEntityStats::Archer };
+
+        for (int i = 0; i < numUnits; ++i)
+        {
+            bool bNorth = (i % 2) == 0;
+            int slot = (i / 2) % 4;
+            float towerX = (randomFloat(rng, 0.f, 1.f) < 0.5f) ? PrincessLeftX : PrincessRightX;
+
+            iEntityStats::MobType type;
+            Vec2 northPos;
+            if (slot < 2)
+            {
+                type = iEntityStats::Rogue;
+                northPos = Vec2(towerX + randomFloat(rng, -3.f, 3.f), NorthPrincessY + randomFloat(rng, -3.f, 3.f));
+            }
+            else if (slot == 2)
+            {
+                type = randomType(rng, kCover, 1);
+                northPos = Vec2(towerX + randomFloat(rng, -2.f, 2.f), NorthPrincessY + randomFloat(rng, 2.f, 4.f));
+            }
+            else
+            {
+                type = randomType(rng, kAttackers, 2);
+                northPos = Vec2(randomFloat(rng, 0.5f, GAME_GRID_WIDTH - 0.5f), RIVER_TOP_Y - randomFloat(rng, 0.5f, 2.f));
+            }
+
+            Game::get().getPlayer(bNorth).spawnMob(type, toSide(northPos, bNorth));
+        }
+    }
+}
+
+const std::vector<BenchmarkScenario>& getBenchmarkScenarios()
+{
+    static const std::vector<BenchmarkScenario> sScenarios =
+    {
+        { "empty",          setupEmpty,         0,      false },
+        { "bridge_brawl",   setupBridgeBrawl,   20,     true },
+        { "mixed",          setupMixed,         200,    true },
+        { "rogue_hide",     setupRogueHide,     40,     true },
+    };
+
+    return sScenarios;
+}
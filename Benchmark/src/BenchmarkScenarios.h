@@ -0,0 +1,41 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <random>
+#include <vector>
+
+// Each scenario fills an empty board (both players, no controllers) with 
+// units, drawing every random choice from the generator it's given.  The
+// same seed and unit count always produce exactly the same board.
+typedef void (*ScenarioSetupFn)(std::mt19937& rng, int numUnits);
+
+struct BenchmarkScenario
+{
+    const char* m_Name;
+    ScenarioSetupFn m_pSetup;
+    int m_NumUnits;         // the default, for both sides together
+    bool m_bScales;         // false if the unit count is meaningless (the empty board)
+};
+
+const std::vector<BenchmarkScenario>& getBenchmarkScenarios();
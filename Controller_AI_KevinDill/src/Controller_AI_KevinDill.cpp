@@ -26,8 +26,8 @@
 #include "iPlayer.h"
 #include "Vec2.h"
 
-void Controller_AI_KevinDill::tick(float deltaTSec, const std::vector<Entity *> allyMobs,
-                                   const std::vector<Entity *> enemyMobs) {
+void Controller_AI_KevinDill::tick(float deltaTSec, const std::vector<Entity *>& allyMobs,
+                                   const std::vector<Entity *>& enemyMobs) {
     assert(m_pPlayer);
     srand(time(nullptr));
 
@@ -40,7 +40,11 @@ void Controller_AI_KevinDill::tick(float deltaTSec, const std::vector<Entity *>
     // defense in random tick
     if (defenseCount >= defenseDuration) {
         // std::cout << "defense" << std::endl;
-        playGame(allyMobs, enemyMobs);
+        // Everything the AI works out from here on is only needed for this
+        // tick, so it all goes in the frame arena.
+        FrameVector<Entity *> allies(allyMobs.begin(), allyMobs.end());
+        FrameVector<Entity *> enemies(enemyMobs.begin(), enemyMobs.end());
+        playGame(allies, enemies);
         defenseCount = 0;
         defenseDuration = rand() % 25 + 10;
     } else {
@@ -48,7 +52,7 @@ void Controller_AI_KevinDill::tick(float deltaTSec, const std::vector<Entity *>
     }
 }
 
-void Controller_AI_KevinDill::playGame(std::vector<Entity *> allyMobs, std::vector<Entity *> enemyMobs) {
+void Controller_AI_KevinDill::playGame(const FrameVector<Entity *>& allyMobs, const FrameVector<Entity *>& enemyMobs) {
     assert(m_pPlayer);
     std::cout << "----------------New Round. " << "Desire to attack = " << desireToAttack << "-------------------------" << std::endl;
 
@@ -105,7 +109,7 @@ void Controller_AI_KevinDill::playGame(std::vector<Entity *> allyMobs, std::vect
             std::cout << "Decision Branch: Enemy has high threat." << std::endl;
             // aggressive strategy only cares about archers
             if (desireToAttack == 3) {
-                std::vector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, enemyMobs);
+                FrameVector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, enemyMobs);
                 if (!archers.empty()) {
                     std::cout << "Decision: Only defense from archers since AI wants to save elixir to attack." << std::endl;
                     dealWithOneEnemy(allyMobs, enemyMobs, getHighestPriorityEnemy(archers));
@@ -154,7 +158,7 @@ void Controller_AI_KevinDill::playGame(std::vector<Entity *> allyMobs, std::vect
             // aggressive strategy only cares about archers
             if (desireToAttack == 3) {
                 std::cout << "Decision Branch: High desire to attack" << std::endl;
-                std::vector<Entity*> archers = getMobInCertainType(iEntityStats::Archer, enemyMobs);
+                FrameVector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, enemyMobs);
                 if (!archers.empty()) {
                     std::cout << "Decision Branch: Simply deal archers." << std::endl;
                     dealWithOneEnemy(allyMobs, enemyMobs, getHighestPriorityEnemy(archers));
@@ -171,8 +175,8 @@ void Controller_AI_KevinDill::playGame(std::vector<Entity *> allyMobs, std::vect
     }
 }
 
-void Controller_AI_KevinDill::organizeAttacks(int aggressiveLevel, const std::vector<Entity *> allyMobs,
-                                              const std::vector<Entity *> enemyMobs) {
+void Controller_AI_KevinDill::organizeAttacks(int aggressiveLevel, const FrameVector<Entity *>& allyMobs,
+                                              const FrameVector<Entity *>& enemyMobs) {
     switch (aggressiveLevel) {
         case 1:
             passiveAttack(allyMobs, enemyMobs);
@@ -190,15 +194,15 @@ void Controller_AI_KevinDill::organizeAttacks(int aggressiveLevel, const std::ve
 }
 
 void
-Controller_AI_KevinDill::aggressiveAttack(const std::vector<Entity *> allyMobs, const std::vector<Entity *> enemyMobs) {
+Controller_AI_KevinDill::aggressiveAttack(const FrameVector<Entity *>& allyMobs, const FrameVector<Entity *>& enemyMobs) {
     std::cout << "agressive attack mode." << std::endl;
 
     assert(m_pPlayer);
 
-    std::vector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, allyMobs);
-    std::vector<Entity *> swords = getMobInCertainType(iEntityStats::Swordsman, allyMobs);
-    std::vector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, allyMobs);
-    std::vector<Entity*> rogues = getMobInCertainType(iEntityStats::Rogue, allyMobs);
+    FrameVector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, allyMobs);
+    FrameVector<Entity *> swords = getMobInCertainType(iEntityStats::Swordsman, allyMobs);
+    FrameVector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, allyMobs);
+    FrameVector<Entity *> rogues = getMobInCertainType(iEntityStats::Rogue, allyMobs);
 
 
     // if no giants exist,
@@ -257,7 +261,7 @@ Controller_AI_KevinDill::aggressiveAttack(const std::vector<Entity *> allyMobs,
 }
 
 void
-Controller_AI_KevinDill::normalAttack(const std::vector<Entity *> allyMobs, const std::vector<Entity *> enemyMobs) {
+Controller_AI_KevinDill::normalAttack(const FrameVector<Entity *>& allyMobs, const FrameVector<Entity *>& enemyMobs) {
     std::cout << "normal attack mode." << std::endl;
 
     assert(m_pPlayer);
@@ -267,10 +271,10 @@ Controller_AI_KevinDill::normalAttack(const std::vector<Entity *> allyMobs, cons
         return;
     }
 
-    std::vector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, allyMobs);
-    std::vector<Entity *> swords = getMobInCertainType(iEntityStats::Swordsman, allyMobs);
-    std::vector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, allyMobs);
-    std::vector<Entity*> rogues = getMobInCertainType(iEntityStats::Rogue, allyMobs);
+    FrameVector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, allyMobs);
+    FrameVector<Entity *> swords = getMobInCertainType(iEntityStats::Swordsman, allyMobs);
+    FrameVector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, allyMobs);
+    FrameVector<Entity *> rogues = getMobInCertainType(iEntityStats::Rogue, allyMobs);
 
 
     if (m_pPlayer->getElixir() >= 5) {
@@ -320,13 +324,13 @@ Controller_AI_KevinDill::normalAttack(const std::vector<Entity *> allyMobs, cons
 }
 
 void
-Controller_AI_KevinDill::passiveAttack(const std::vector<Entity *> allyMobs, const std::vector<Entity *> enemyMobs) {
+Controller_AI_KevinDill::passiveAttack(const FrameVector<Entity *>& allyMobs, const FrameVector<Entity *>& enemyMobs) {
     std::cout << "passive attack mode." << std::endl;
 
     assert(m_pPlayer);
 
-    std::vector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, allyMobs);
-    std::vector<Entity*> rogues = getMobInCertainType(iEntityStats::Rogue, allyMobs);
+    FrameVector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, allyMobs);
+    FrameVector<Entity *> rogues = getMobInCertainType(iEntityStats::Rogue, allyMobs);
 
     if (getMobsThreatLevel(allyMobs) - getMobsThreatLevel(enemyMobs) > 3.f) {
         if (m_pPlayer->getElixir() >= 5) {
@@ -360,14 +364,14 @@ Controller_AI_KevinDill::passiveAttack(const std::vector<Entity *> allyMobs, con
     }
 }
 
-void Controller_AI_KevinDill::defense(const std::vector<Entity *> &allyMobs, const std::vector<Entity *> &enemyMobs) {
+void Controller_AI_KevinDill::defense(const FrameVector<Entity *>& allyMobs, const FrameVector<Entity *>& enemyMobs) {
     assert(m_pPlayer);
 
     // get all the enemy mobs that pass the bridge
-    std::vector<Entity *> mobsPassBridge = getMobsWithinRange(m_pPlayer->isNorth(), enemyMobs);
+    FrameVector<Entity *> mobsPassBridge = getMobsWithinRange(m_pPlayer->isNorth(), enemyMobs);
 
     // get all mobs that needs extra defense
-    std::vector<Entity *> mobsShouldTakeCare = getEnemyShouldTakeCare(mobsPassBridge);
+    FrameVector<Entity *> mobsShouldTakeCare = getEnemyShouldTakeCare(mobsPassBridge);
 
     // 1. if has enemy that should take care:
     // 2. deal with this enemy until it is solved
@@ -388,11 +392,11 @@ void Controller_AI_KevinDill::defense(const std::vector<Entity *> &allyMobs, con
     }
 }
 
-std::vector<Entity *>
-Controller_AI_KevinDill::getMobsOnThisSide(bool isNorth, const std::vector<Entity *> &mobs) {
+FrameVector<Entity *>
+Controller_AI_KevinDill::getMobsOnThisSide(bool isNorth, const FrameVector<Entity *>& mobs) {
     assert(m_pPlayer);
 
-    std::vector<Entity *> result = std::vector<Entity *>();
+    FrameVector<Entity *> result;
 
     for (auto e: mobs) {
         if (isOnThisSide(m_pPlayer->isNorth(), e->getPosition())) {
@@ -411,13 +415,13 @@ bool Controller_AI_KevinDill::isOnThisSide(bool isNorth, const Vec2 &pos) {
     }
 }
 
-std::vector<Entity *>
-Controller_AI_KevinDill::getEnemyShouldTakeCare(std::vector<Entity *> enemyMobs) {
-    std::vector<Entity *> result = std::vector<Entity *>();
+FrameVector<Entity *>
+Controller_AI_KevinDill::getEnemyShouldTakeCare(const FrameVector<Entity *>& enemyMobs) {
+    FrameVector<Entity *> result;
 
     for (auto e: enemyMobs) {
         // if the enemy is untreated
-        if (enemyTreated.find(e) == enemyTreated.end()) {
+        if (!enemyTreated.contains(e->getHandle())) {
             result.push_back(e);
         }
     }
@@ -426,7 +430,7 @@ Controller_AI_KevinDill::getEnemyShouldTakeCare(std::vector<Entity *> enemyMobs)
 }
 
 bool
-Controller_AI_KevinDill::dealWithOneEnemy(const std::vector<Entity *> &allyMobs, const std::vector<Entity *> &enemyMobs,
+Controller_AI_KevinDill::dealWithOneEnemy(const FrameVector<Entity *>& allyMobs, const FrameVector<Entity *>& enemyMobs,
                                           Entity *enemy) {
     assert(m_pPlayer);
 
@@ -453,7 +457,7 @@ Controller_AI_KevinDill::dealWithOneEnemy(const std::vector<Entity *> &allyMobs,
 
     // if notice level is enough, do nothing, update treated enemy
     if (noticeOnThisEnemy >= enemy->getStats().getElixirCost() + rand() % 2 - 1) {
-        enemyTreated.insert(enemy);
+        enemyTreated.insert(enemy->getHandle());
         return false;
     } else {
         // place the mob
@@ -512,15 +516,15 @@ iEntityStats::MobType Controller_AI_KevinDill::intToMob(int num) {
     }
 }
 
-Entity *Controller_AI_KevinDill::getHighestPriorityEnemy(std::vector<Entity *> enemyMobs) {
+Entity *Controller_AI_KevinDill::getHighestPriorityEnemy(const FrameVector<Entity *>& enemyMobs) {
     // basic idea: archer behind giant > rogue behind giant > swordsman behind giant >
     // giant > swordsman
     assert(m_pPlayer);
 
-    std::vector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, enemyMobs);
-    std::vector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, enemyMobs);
-    std::vector<Entity *> swords = getMobInCertainType(iEntityStats::Swordsman, enemyMobs);
-    std::vector<Entity *> rogues = getMobInCertainType(iEntityStats::Rogue, enemyMobs);
+    FrameVector<Entity *> giants = getMobInCertainType(iEntityStats::Giant, enemyMobs);
+    FrameVector<Entity *> archers = getMobInCertainType(iEntityStats::Archer, enemyMobs);
+    FrameVector<Entity *> swords = getMobInCertainType(iEntityStats::Swordsman, enemyMobs);
+    FrameVector<Entity *> rogues = getMobInCertainType(iEntityStats::Rogue, enemyMobs);
 
     float towerY = m_pPlayer->isNorth() ? NorthPrincessY : SouthPrincessY;
     Vec2 leftTowerPos = Vec2(PrincessLeftX, towerY);
@@ -631,9 +635,9 @@ Entity *Controller_AI_KevinDill::getHighestPriorityEnemy(std::vector<Entity *> e
     return nullptr;
 }
 
-std::vector<Entity *>
-Controller_AI_KevinDill::getMobInCertainType(iEntityStats::MobType mobType, const std::vector<Entity *> &mobs) {
-    std::vector<Entity *> result = std::vector<Entity *>();
+FrameVector<Entity *>
+Controller_AI_KevinDill::getMobInCertainType(iEntityStats::MobType mobType, const FrameVector<Entity *>& mobs) {
+    FrameVector<Entity *> result;
 
     for (auto e: mobs) {
         if (e->getStats().getMobType() == mobType) {
@@ -652,7 +656,7 @@ bool Controller_AI_KevinDill::aBehindB(bool isNorth, Entity *mobA, Entity *mobB)
     return isBehind && onSameSide;
 }
 
-Entity *Controller_AI_KevinDill::getClosestMob(std::vector<Entity *> mobs, Vec2 pos) {
+Entity *Controller_AI_KevinDill::getClosestMob(const FrameVector<Entity *>& mobs, Vec2 pos) {
     float closestDistance = 9999;
     Entity *returnMob = nullptr;
 
@@ -665,7 +669,7 @@ Entity *Controller_AI_KevinDill::getClosestMob(std::vector<Entity *> mobs, Vec2
     return returnMob;
 }
 
-float Controller_AI_KevinDill::getMobsThreatLevel(std::vector<Entity *> mobs) {
+float Controller_AI_KevinDill::getMobsThreatLevel(const FrameVector<Entity *>& mobs) {
     float threatLevel = 0;
 
     for (auto m: mobs) {
@@ -720,10 +724,10 @@ bool Controller_AI_KevinDill::isPosOnLeft(Vec2 pos) {
 }
 
 // get the mobs that will pass the bridge
-std::vector<Entity*> Controller_AI_KevinDill::getMobsWithinRange(bool isNorth, const std::vector<Entity*>& mobs) {
+FrameVector<Entity *> Controller_AI_KevinDill::getMobsWithinRange(bool isNorth, const FrameVector<Entity *>& mobs) {
     assert(m_pPlayer);
 
-    std::vector<Entity *> result = std::vector<Entity *>();
+    FrameVector<Entity *> result;
 
     for (auto e: mobs) {
         if (isWithinRange(m_pPlayer->isNorth(), e->getPosition())) {
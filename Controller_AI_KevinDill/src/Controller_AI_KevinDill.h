@@ -22,10 +22,13 @@
 
 #pragma once
 
-#include <set>
+#include "EntityHandle.h"
+#include "FrameArena.h"
 #include "iController.h"
 #include "../../Game/src/Entity.h"
 
+#include <algorithm>
+
 
 
 class Controller_AI_KevinDill : public iController
@@ -34,7 +37,11 @@ public:
     Controller_AI_KevinDill() {}
     virtual ~Controller_AI_KevinDill() {}
 
-    void tick(float deltaTSec, std::vector<Entity *> allyMobs, std::vector<Entity *> enemyMobs);
+    void tick(float deltaTSec, const std::vector<Entity*>& allyMobs, const std::vector<Entity*>& enemyMobs);
+
+    // Between rounds all we do is count ticks
+    virtual int getIdleTicks() const { return firstTick ? 0 : std::max(0, defenseDuration - defenseCount); }
+    virtual void skipTicks(int numTicks) { assert(numTicks <= getIdleTicks()); defenseCount += numTicks; }
 
     int GetFoo() const { return m_foo; }
 
@@ -50,13 +57,14 @@ private:
     bool firstTick = true;
 
     // the enemy that already treated by AI, what if the enemy is in the list but no mobs nearby to deal with it?
-    std::set<Entity*> enemyTreated = std::set<Entity*>();
+    // keyed by handle, so enemies that die (and whose slots get reused) drop out by themselves
+    EntityHandleSet enemyTreated = EntityHandleSet();
 
     // play the game with attacks and defense
-    void playGame(std::vector<Entity*> allyMobs, std::vector<Entity*> enemyMobs);
+    void playGame(const FrameVector<Entity*>& allyMobs, const FrameVector<Entity*>& enemyMobs);
 
     // organize attacks module: 3 = very aggressive, 2 = medium, 1 = passive
-    void organizeAttacks(int aggressiveLevel, std::vector<Entity*> allyMobs, std::vector<Entity*> enemyMobs);
+    void organizeAttacks(int aggressiveLevel, const FrameVector<Entity*>& allyMobs, const FrameVector<Entity*>& enemyMobs);
 
     // * all in elixir on attack
     // 1. if no enemy, organize attack on top of bridge
@@ -64,35 +72,35 @@ private:
     // 3. if enemy has very large threat(may break the king tower), defense at lowest level -> most threat mob, ignore
     // single archer and rogue
     // 4. if has giant or knight at front, place archer when enough elixir
-    void aggressiveAttack(std::vector<Entity*> allyMobs, std::vector<Entity*> enemyMobs);
+    void aggressiveAttack(const FrameVector<Entity*>& allyMobs, const FrameVector<Entity*>& enemyMobs);
 
     // * if no enemy, organize attack when elixir = 10, else always save 2 elixir
     // 1. if no enemy, place giant on the bottom first, then add archers when giant pass the bridge
     // 2. if has enemy, defense first. After defense, if has mobs left, when mob almost reach bridge, place giant on
     // bridge; if no mobs left, wait until elixir = 10
-    void normalAttack(std::vector<Entity*> allyMobs, std::vector<Entity*> enemyMobs);
+    void normalAttack(const FrameVector<Entity*>& allyMobs, const FrameVector<Entity*>& enemyMobs);
 
     // * will not actively attack, move when enemy move, will save rogues on back of the tower when elixir = 10
     // attack when there are mobs left and enough for a giant
-    void passiveAttack(std::vector<Entity*> allyMobs, std::vector<Entity*> enemyMobs);
+    void passiveAttack(const FrameVector<Entity*>& allyMobs, const FrameVector<Entity*>& enemyMobs);
 
     // * will not move when current mobs can protect tower from this attack
     // * place one mob each time in order to behave like human players
     // hide rogue + archer/swordsman -> giant, archer/swordsman -> swordsman, swordsman -> rogue, swordsman -> archer
-    void defense(const std::vector<Entity*>& allyMobs, const std::vector<Entity*>& enemyMobs);
+    void defense(const FrameVector<Entity*>& allyMobs, const FrameVector<Entity*>& enemyMobs);
 
     // get the mobs that will pass the bridge
-    std::vector<Entity*> getMobsOnThisSide(bool isNorth, const std::vector<Entity*>& mobs);
+    FrameVector<Entity*> getMobsOnThisSide(bool isNorth, const FrameVector<Entity*>& mobs);
 
     // check whether the mob is on this side or opponent's side
     static bool isOnThisSide(bool isNorth, const Vec2& pos);
 
     // get all the enemy that should take care -> enemies not in the treated set
     // also remove all the archers or rogues that without protection of swordsman or giant
-    std::vector<Entity *> getEnemyShouldTakeCare(std::vector<Entity *> entity);
+    FrameVector<Entity*> getEnemyShouldTakeCare(const FrameVector<Entity*>& entity);
 
     // defense from a enemy depends on the exist ally mobs
-    bool dealWithOneEnemy(const std::vector<Entity*>& allyMobs, const std::vector<Entity*>& enemyMobs,Entity* enemy);
+    bool dealWithOneEnemy(const FrameVector<Entity*>& allyMobs, const FrameVector<Entity*>& enemyMobs,Entity* enemy);
 
     // generate a random number in a range
     static float randomInRange(float lowerBound, float upperBound);
@@ -106,19 +114,19 @@ private:
     // get the enemy that with the highest priority to be dealt with
     // basic idea: archer behind giant > rogue behind giant > swordsman behind giant >
     // giant far from tower > swordsman > giant far from tower
-    Entity* getHighestPriorityEnemy(std::vector<Entity *> enemyMobs);
+    Entity* getHighestPriorityEnemy(const FrameVector<Entity*>& enemyMobs);
 
     // get certain type of mob in a vector
-    std::vector<Entity *> getMobInCertainType(iEntityStats::MobType mobType, const std::vector<Entity *>& mobs);
+    FrameVector<Entity*> getMobInCertainType(iEntityStats::MobType mobType, const FrameVector<Entity*>& mobs);
 
     // returns whether one entity is behind another
     bool aBehindB(bool isNorth, Entity *mobA, Entity *mobB);
 
     // get the closest mob to a position
-    Entity* getClosestMob(std::vector<Entity* > mobs, Vec2 pos);
+    Entity* getClosestMob(const FrameVector<Entity*>& mobs, Vec2 pos);
 
     // evaluate the threat level of a group of mobs
-    float getMobsThreatLevel(std::vector<Entity* > mobs);
+    float getMobsThreatLevel(const FrameVector<Entity*>& mobs);
 
     // get the tolerance of the mob depends on the current strategy.
     float getThreatTolerance();
@@ -136,7 +144,7 @@ private:
     bool isPosOnLeft(Vec2 pos);
 
     // get the mobs that will pass the bridge
-    std::vector<Entity*> getMobsWithinRange(bool isNorth, const std::vector<Entity*>& mobs);
+    FrameVector<Entity*> getMobsWithinRange(bool isNorth, const FrameVector<Entity*>& mobs);
 
     // check whether the mob is on this side or opponent's side
     static bool isWithinRange(bool isNorth, const Vec2& pos);
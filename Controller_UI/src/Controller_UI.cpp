@@ -37,45 +37,51 @@ Controller_UI::~Controller_UI()
         << "you made more than one." << std::endl;
 }
 
-void Controller_UI::tick(float deltaTSec, const std::vector<Entity *> vector, const std::vector<Entity *> vector1) {
-    while(!events.empty()) {
-        SDL_Event e = events.front();
-        events.pop();
+void Controller_UI::tick(float deltaTSec, const std::vector<Entity *>& vector, const std::vector<Entity *>& vector1) {
+    // Grab everything that's been queued up so far, so that we don't hold the
+    // lock while we place the mobs.  The two vectors trade places every tick
+    // and keep their capacity, so neither has to allocate once both have grown.
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ToPlace.swap(placements);
+    }
 
-        if ((e.type == SDL_MOUSEBUTTONUP) && (e.button.button == SDL_BUTTON_LEFT)) {
-            int pixelX = -1;
-            int pixelY = -1;
-            SDL_GetMouseState(&pixelX, &pixelY);
-            const Vec2 mousePos((float)(pixelX / PIXELS_PER_METER), (float)(pixelY / PIXELS_PER_METER));
+    for (const Placement& placement : m_ToPlace) {
+        assert(m_pPlayer);
+        m_pPlayer->placeMob(placement.m_Type, placement.m_Pos);
+    }
+    m_ToPlace.clear();
+}
 
-            iEntityStats::MobType mobType;
-            if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_A])
-            {
-                mobType = iEntityStats::Archer;
-            }
-            else if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_S])
-            {
-                mobType = iEntityStats::Swordsman;
-            }
-            else if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_G])
-            {
-                mobType = iEntityStats::Giant;
-            }
-            else if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_R])
-            {
-                mobType = iEntityStats::Rogue;
-            }
-            else
-            {
-                continue;
-            }
+void Controller_UI::loadEvent(SDL_Event e) {
+    if ((e.type == SDL_MOUSEBUTTONUP) && (e.button.button == SDL_BUTTON_LEFT)) {
+        const int pixelX = e.button.x;
+        const int pixelY = e.button.y;
+        const Vec2 mousePos((float)(pixelX / PIXELS_PER_METER), (float)(pixelY / PIXELS_PER_METER));
 
-            assert(m_pPlayer);
-            m_pPlayer->placeMob(mobType, mousePos);
+        iEntityStats::MobType mobType;
+        if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_A])
+        {
+            mobType = iEntityStats::Archer;
+        }
+        else if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_S])
+        {
+            mobType = iEntityStats::Swordsman;
+        }
+        else if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_G])
+        {
+            mobType = iEntityStats::Giant;
         }
+        else if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_R])
+        {
+            mobType = iEntityStats::Rogue;
+        }
+        else
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        placements.push_back(Placement(mobType, mousePos));
     }
 }
-
-void Controller_UI::loadEvent(SDL_Event e) {
-    events.push(e);
-}
\ No newline at end of file
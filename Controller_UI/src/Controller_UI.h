@@ -23,7 +23,8 @@
 #pragma once
 
 #include "iController.h"
-#include <queue>
+#include <mutex>
+#include <vector>
 #include "SDL.h"
 #include <Singleton.h>
 
@@ -52,11 +53,24 @@ public:
     Controller_UI() {}
     virtual ~Controller_UI();
 
-    void tick(float deltaTSec, const std::vector<Entity *> vector, const std::vector<Entity *> vector1);
+    void tick(float deltaTSec, const std::vector<Entity *>& vector, const std::vector<Entity *>& vector1);
+
+    // NOTE: This is called from the thread that pumps SDL events, while tick() is
+    // called from the simulation thread.  Anything that needs SDL state (like
+    // which keys are down) is read here, so that tick() doesn't touch SDL.
     void loadEvent(SDL_Event e);
 
 private:
-    
-    std::queue<SDL_Event> events;
+    struct Placement
+    {
+        Placement(iEntityStats::MobType type, const Vec2& pos) : m_Type(type), m_Pos(pos) {}
+
+        iEntityStats::MobType m_Type;
+        Vec2 m_Pos;
+    };
+
+    std::mutex m_Mutex;             // guards placements
+    std::vector<Placement> placements;
+    std::vector<Placement> m_ToPlace;   // only touched by tick()
 
 };
\ No newline at end of file
@@ -0,0 +1,412 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AllocTracker.h"
+
+#include "SimStats.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef CRASHLOYAL_ALLOC_TRACKING
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#define ALLOC_TRACKER_STACKS
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <cxxabi.h>
+#include <execinfo.h>
+#define ALLOC_TRACKER_STACKS
+#endif
+#endif
+
+#ifdef _MSC_VER
+#define ALLOC_TRACKER_NOINLINE __declspec(noinline)
+#else
+#define ALLOC_TRACKER_NOINLINE __attribute__((noinline))
+#endif
+
+static_assert(SimStats::NumPhases <= AllocTracker::kMaxPhases, "AllocTracker needs more phases");
+
+namespace
+{
+    const int kSiteDepth = 6;           // frames kept for each call site
+    const int kSkipFrames = 2;          // recordAllocation() and operator new
+    const int kMaxSites = 4096;
+
+    struct Site
+    {
+        void* m_Frames[kSiteDepth];
+        int m_NumFrames;
+        uint64_t m_NumAllocations;
+        uint64_t m_NumBytes;
+    };
+
+    // NOTE: All of this is zero initialized before any constructors run, so 
+    // it's safe to use from allocations made during static initialization.
+    // The last bucket is for kNoPhase.
+    std::atomic<uint64_t> s_NumAllocations[AllocTracker::kMaxPhases + 1];
+    std::atomic<uint64_t> s_NumBytes[AllocTracker::kMaxPhases + 1];
+    std::atomic<uint64_t> s_NumFrees;
+
+    std::mutex s_SiteMutex;
+    Site s_Sites[kMaxSites];            // open addressing, keyed on the frames
+    int s_NumSites;
+    uint64_t s_NumUntrackedSites;       // allocations that didn't fit in s_Sites
+
+    thread_local int t_Phase = AllocTracker::kNoPhase;
+
+    // Set while the tracker itself is running, so that anything it allocates
+    // (the unwinder, the report) isn't counted and can't recurse.
+    thread_local bool t_bInTracker = false;
+
+    int getBucket(int phase)
+    {
+        assert((phase >= AllocTracker::kNoPhase) && (phase < AllocTracker::kMaxPhases));
+        return (phase == AllocTracker::kNoPhase) ? AllocTracker::kMaxPhases : phase;
+    }
+
+    int captureStack(void** pFrames)
+    {
+#if defined(ALLOC_TRACKER_STACKS) && defined(_WIN32)
+        return (int)CaptureStackBackTrace(kSkipFrames, kSiteDepth, pFrames, NULL);
+#elif defined(ALLOC_TRACKER_STACKS)
+        void* allFrames[kSkipFrames + kSiteDepth];
+        int numFrames = backtrace(allFrames, kSkipFrames + kSiteDepth) - kSkipFrames;
+        numFrames = std::max(0, numFrames);
+        memcpy(pFrames, allFrames + kSkipFrames, numFrames * sizeof(void*));
+        return numFrames;
+#else
+        (void)pFrames;
+        return 0;
+#endif
+    }
+
+    void recordSite(size_t numBytes)
+    {
+        void* frames[kSiteDepth];
+        int numFrames = captureStack(frames);
+        if (numFrames <= 0) { return; }
+
+        uint64_t hash = 14695981039346656037ull;
+        for (int i = 0; i < numFrames; ++i)
+        {
+            hash = (hash ^ (uint64_t)(uintptr_t)frames[i]) * 1099511628211ull;
+        }
+
+        std::lock_guard<std::mutex> lock(s_SiteMutex);
+        for (int probe = 0; probe < kMaxSites; ++probe)
+        {
+            Site& site = s_Sites[(hash + probe) % kMaxSites];
+            if (site.m_NumAllocations == 0)
+            {
+                if (s_NumSites >= kMaxSites / 2) { break; }      // keep probes short
+
+                memcpy(site.m_Frames, frames, sizeof(frames));
+                site.m_NumFrames = numFrames;
+                ++s_NumSites;
+            }
+            else if ((site.m_NumFrames != numFrames) ||
+                     memcmp(site.m_Frames, frames, numFrames * sizeof(void*)))
+            {
+                continue;
+            }
+
+            ++site.m_NumAllocations;
+            site.m_NumBytes += numBytes;
+            return;
+        }
+
+        ++s_NumUntrackedSites;
+    }
+
+    void writeFrames(FILE* pFile, void* const* pFrames, int numFrames)
+    {
+#if defined(ALLOC_TRACKER_STACKS) && defined(_WIN32)
+        HANDLE process = GetCurrentProcess();
+        static bool sbSymbolsLoaded = false;
+        if (!sbSymbolsLoaded)
+        {
+            SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+            SymInitialize(process, NULL, TRUE);
+            sbSymbolsLoaded = true;
+        }
+
+        char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+        SYMBOL_INFO* pSymbol = (SYMBOL_INFO*)buffer;
+        for (int i = 0; i < numFrames; ++i)
+        {
+            memset(buffer, 0, sizeof(buffer));
+            pSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+            pSymbol->MaxNameLen = MAX_SYM_NAME;
+
+            DWORD64 address = (DWORD64)pFrames[i];
+            DWORD lineOffset = 0;
+            IMAGEHLP_LINE64 line = { sizeof(IMAGEHLP_LINE64) };
+            if (!SymFromAddr(process, address, NULL, pSymbol))
+                fprintf(pFile, "        %p\n", pFrames[i]);
+            else if (SymGetLineFromAddr64(process, address, &lineOffset, &line))
+                fprintf(pFile, "        %s (%s:%lu)\n", pSymbol->Name, line.FileName, line.LineNumber);
+            else
+                fprintf(pFile, "        %s\n", pSymbol->Name);
+        }
+#elif defined(ALLOC_TRACKER_STACKS)
+        // NOTE: Names only show up for symbols that are exported, which is why
+        // CMake links with ENABLE_EXPORTS when tracking is on.  The rest are
+        // left as addresses (addr2line can turn them into lines).
+        char** pSymbols = backtrace_symbols(pFrames, numFrames);
+        for (int i = 0; i < numFrames; ++i)
+        {
+            const char* pText = pSymbols ? pSymbols[i] : "?";
+            std::string name(pText);
+
+            // glibc gives "binary(mangled+0x12) [0x...]"
+            size_t begin = name.find('(');
+            size_t end = name.find('+', begin);
+            if ((begin != std::string::npos) && (end != std::string::npos) && (end > begin + 1))
+            {
+                std::string mangled = name.substr(begin + 1, end - begin - 1);
+                int status = 0;
+                char* pDemangled = abi::__cxa_demangle(mangled.c_str(), NULL, NULL, &status);
+                if (pDemangled && (status == 0))
+                {
+                    name = pDemangled;
+                }
+                free(pDemangled);
+            }
+            fprintf(pFile, "        %s\n", name.c_str());
+        }
+        free(pSymbols);
+#else
+        for (int i = 0; i < numFrames; ++i)
+        {
+            fprintf(pFile, "        %p\n", pFrames[i]);
+        }
+#endif
+    }
+
+    bool bySiteCount(const Site& lhs, const Site& rhs)
+    {
+        return lhs.m_NumAllocations > rhs.m_NumAllocations;
+    }
+}
+
+int AllocTracker::enterPhase(int phase)
+{
+    int previous = t_Phase;
+    t_Phase = phase;
+    return previous;
+}
+
+void AllocTracker::leavePhase(int previousPhase)
+{
+    t_Phase = previousPhase;
+}
+
+uint64_t AllocTracker::getNumAllocations(int phase)
+{
+    return s_NumAllocations[getBucket(phase)].load(std::memory_order_relaxed);
+}
+
+uint64_t AllocTracker::getNumBytes(int phase)
+{
+    return s_NumBytes[getBucket(phase)].load(std::memory_order_relaxed);
+}
+
+uint64_t AllocTracker::getNumSimAllocations()
+{
+    uint64_t total = 0;
+    for (int i = 0; i < kMaxPhases; ++i)
+    {
+        total += s_NumAllocations[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t AllocTracker::getNumFrees()
+{
+    return s_NumFrees.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::reset()
+{
+    for (int i = 0; i <= kMaxPhases; ++i)
+    {
+        s_NumAllocations[i] = 0;
+        s_NumBytes[i] = 0;
+    }
+    s_NumFrees = 0;
+
+    std::lock_guard<std::mutex> lock(s_SiteMutex);
+    memset(s_Sites, 0, sizeof(s_Sites));
+    s_NumSites = 0;
+    s_NumUntrackedSites = 0;
+}
+
+void AllocTracker::writeReport(FILE* pFile, int maxSites)
+{
+    if (!isCompiledIn())
+    {
+        fprintf(pFile, "Allocation tracking isn't compiled in (build with CRASHLOYAL_ALLOC_TRACKING).\n");
+        return;
+    }
+
+    bool bWasInTracker = t_bInTracker;
+    t_bInTracker = true;
+
+    fprintf(pFile, "Heap allocations by phase:\n");
+    for (int i = 0; i <= SimStats::NumPhases; ++i)
+    {
+        int phase = (i < SimStats::NumPhases) ? i : kNoPhase;
+        fprintf(pFile, "    %-12s %12llu allocs %14llu bytes\n",
+            (phase == kNoPhase) ? "outside" : SimStats::getPhaseName((SimStats::Phase)phase),
+            (unsigned long long)getNumAllocations(phase),
+            (unsigned long long)getNumBytes(phase));
+    }
+    fprintf(pFile, "    %-12s %12llu\n", "frees", (unsigned long long)getNumFrees());
+
+    std::vector<Site> sites;
+    uint64_t numUntracked = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_SiteMutex);
+        for (int i = 0; i < kMaxSites; ++i)
+        {
+            if (s_Sites[i].m_NumAllocations > 0)
+                sites.push_back(s_Sites[i]);
+        }
+        numUntracked = s_NumUntrackedSites;
+    }
+
+    size_t numToShow = std::min(sites.size(), (size_t)std::max(0, maxSites));
+    std::partial_sort(sites.begin(), sites.begin() + numToShow, sites.end(), bySiteCount);
+
+    fprintf(pFile, "Busiest allocation sites in the simulation (%d of %d):\n", (int)numToShow, (int)sites.size());
+    for (size_t i = 0; i < numToShow; ++i)
+    {
+        fprintf(pFile, "  %2d. %llu allocs, %llu bytes\n", (int)i + 1,
+            (unsigned long long)sites[i].m_NumAllocations,
+            (unsigned long long)sites[i].m_NumBytes);
+        writeFrames(pFile, sites[i].m_Frames, sites[i].m_NumFrames);
+    }
+    if (numUntracked > 0)
+    {
+        fprintf(pFile, "  (%llu allocations came from sites that didn't fit in the table)\n", (unsigned long long)numUntracked);
+    }
+
+    t_bInTracker = bWasInTracker;
+}
+
+ALLOC_TRACKER_NOINLINE void AllocTracker::recordAllocation(size_t numBytes)
+{
+    if (t_bInTracker) { return; }
+
+    int phase = t_Phase;
+    int bucket = getBucket(phase);
+    s_NumAllocations[bucket].fetch_add(1, std::memory_order_relaxed);
+    s_NumBytes[bucket].fetch_add(numBytes, std::memory_order_relaxed);
+
+    // Only the simulation's allocations are worth a call stack
+    if (phase != kNoPhase)
+    {
+        t_bInTracker = true;
+        recordSite(numBytes);
+        t_bInTracker = false;
+    }
+}
+
+void AllocTracker::recordFree()
+{
+    if (t_bInTracker) { return; }
+    s_NumFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+#ifdef CRASHLOYAL_ALLOC_TRACKING
+
+// The replacements for the global allocation functions.  Everything is passed
+// through to malloc() and free() once it's been counted.
+
+void* operator new(size_t numBytes)
+{
+    AllocTracker::recordAllocation(numBytes);
+    void* p = malloc(numBytes ? numBytes : 1);
+    if (!p) { throw std::bad_alloc(); }
+    return p;
+}
+
+void* operator new[](size_t numBytes)
+{
+    return operator new(numBytes);
+}
+
+void* operator new(size_t numBytes, const std::nothrow_t&) noexcept
+{
+    AllocTracker::recordAllocation(numBytes);
+    return malloc(numBytes ? numBytes : 1);
+}
+
+void* operator new[](size_t numBytes, const std::nothrow_t& tag) noexcept
+{
+    return operator new(numBytes, tag);
+}
+
+void operator delete(void* p) noexcept
+{
+    if (!p) { return; }
+    AllocTracker::recordFree();
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    operator delete(p);
+}
+
+#endif
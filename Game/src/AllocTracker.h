@@ -0,0 +1,79 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Counts heap allocations and works out where they came from.  When
+// CRASHLOYAL_ALLOC_TRACKING is defined, AllocTracker.cpp replaces the global
+// operator new and delete, and every allocation is charged to the SimStats
+// phase that the allocating thread is in (or to "outside", if it's not in one).
+// Allocations made in a phase also record a short call stack, so that the
+// report can list the sites that allocate the most.
+//
+// Without CRASHLOYAL_ALLOC_TRACKING nothing is replaced and every count
+// reads zero.
+//
+// NOTE: This is deliberately not a Singleton.  operator new can be called
+// before main() and from any thread, and Singleton::get() would itself have
+// to allocate the first time it was called, so all of the state is static.
+class AllocTracker
+{
+public:
+    static const int kNoPhase = -1;
+    static const int kMaxPhases = 8;
+
+    static bool isCompiledIn()
+    {
+#ifdef CRASHLOYAL_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Sets the calling thread's phase and returns the one it replaced, which
+    // should be passed to leavePhase() at the end of the scope.
+    static int enterPhase(int phase);
+    static void leavePhase(int previousPhase);
+
+    // phase may be kNoPhase, for everything allocated outside of the phases
+    static uint64_t getNumAllocations(int phase);
+    static uint64_t getNumBytes(int phase);
+
+    // Everything allocated inside any phase, which is to say by the simulation
+    static uint64_t getNumSimAllocations();
+
+    static uint64_t getNumFrees();
+
+    // Zeroes the counts and forgets the call sites.
+    static void reset();
+
+    // Writes the counts for each phase and the maxSites busiest call sites.
+    static void writeReport(FILE* pFile, int maxSites = 10);
+
+    // Used by the replacement operator new and delete
+    static void recordAllocation(size_t numBytes);
+    static void recordFree();
+};
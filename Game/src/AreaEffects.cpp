@@ -0,0 +1,158 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AreaEffects.h"
+
+#include "DamageBuffer.h"
+#include "Entity.h"
+#include "FrameArena.h"
+#include "Game.h"
+#include "Mob.h"
+#include "Player.h"
+#include "Profiler.h"
+#include "RenderSnapshot.h"
+#include "SimStats.h"
+
+#include <algorithm>
+
+// Enough for a busy match, so casting doesn't allocate
+static const size_t kInitialCapacity = 16;
+
+AreaEffects::AreaEffects()
+{
+    m_Effects.reserve(kInitialCapacity);
+}
+
+void AreaEffects::clear()
+{
+    m_Effects.clear();
+}
+
+void AreaEffects::cast(const iSpellStats& stats, bool bNorth, const Vec2& pos)
+{
+    Effect effect = { &stats, bNorth, pos, stats.getDuration(), false };
+    m_Effects.push_back(effect);
+}
+
+void AreaEffects::update(float deltaTSec, DamageBuffer& damageBuffer)
+{
+    PROFILE_SCOPE("AreaEffects::update");
+
+    for (Effect& effect : m_Effects)
+    {
+        const iSpellStats& stats = *effect.m_pStats;
+        if (!effect.m_bLanded)
+        {
+            if (stats.getDamage() > 0)
+            {
+                applyDamage(effect, damageBuffer);
+            }
+            effect.m_bLanded = true;
+        }
+
+        if (stats.getPullSpeed() > 0.f)
+        {
+            applyPull(effect, deltaTSec);
+        }
+
+        if (stats.getHasteMultiplier() != 1.f)
+        {
+            applyHaste(effect);
+        }
+
+        effect.m_TimeLeft -= deltaTSec;
+    }
+
+    // A spell with no duration still gets the one tick, above
+    m_Effects.erase(std::remove_if(m_Effects.begin(), m_Effects.end(),
+        [](const Effect& effect) { return effect.m_TimeLeft <= 0.f; }),
+        m_Effects.end());
+}
+
+void AreaEffects::applyDamage(const Effect& effect, DamageBuffer& damageBuffer)
+{
+    const Player& enemy = Game::get().getPlayer(!effect.m_bNorth);
+    const float radius = effect.m_pStats->getRadius();
+    const int damage = effect.m_pStats->getDamage();
+
+    FrameVector<Entity*> hit;
+    enemy.findMobsWithin(effect.m_Pos, radius, hit);
+    for (Entity* pMob : hit)
+    {
+        damageBuffer.add(EntityHandle(), pMob->getHandle(), damage);
+    }
+
+    // There are only ever a few buildings, and they're big, so anything that
+    // reaches them counts
+    const PackedPositions& buildings = enemy.getPackedBuildings();
+    for (size_t i = 0; i < buildings.size(); ++i)
+    {
+        const float dx = buildings.m_X[i] - effect.m_Pos.x;
+        const float dy = buildings.m_Y[i] - effect.m_Pos.y;
+        const float reach = radius + buildings.m_HalfSize[i];
+        if (dx * dx + dy * dy <= reach * reach)
+        {
+            damageBuffer.add(EntityHandle(), buildings.m_Entities[i]->getHandle(), damage);
+        }
+    }
+}
+
+void AreaEffects::applyPull(const Effect& effect, float deltaTSec)
+{
+    Player& enemy = Game::get().getPlayer(!effect.m_bNorth);
+
+    // Find everyone first, since pulling them moves them out from under the
+    // packed positions
+    FrameVector<Entity*> pulled;
+    enemy.findMobsWithin(effect.m_Pos, effect.m_pStats->getRadius(), pulled);
+    for (Entity* pEntity : pulled)
+    {
+        static_cast<Mob*>(pEntity)->pullToward(effect.m_Pos, effect.m_pStats->getPullSpeed() * deltaTSec);
+    }
+
+    if (!pulled.empty())
+    {
+        enemy.invalidatePackedPositions();
+    }
+}
+
+void AreaEffects::applyHaste(const Effect& effect)
+{
+    Game& game = Game::get();
+    const double endTime = game.getSimTime() + effect.m_pStats->getHasteLingerTime();
+
+    FrameVector<Entity*> hasted;
+    game.getPlayer(effect.m_bNorth).findMobsWithin(effect.m_Pos, effect.m_pStats->getRadius(), hasted);
+    for (Entity* pEntity : hasted)
+    {
+        pEntity->applyHaste(effect.m_pStats->getHasteMultiplier(), endTime);
+    }
+}
+
+void AreaEffects::addToSnapshot(RenderSnapshot& snapshot) const
+{
+    for (const Effect& effect : m_Effects)
+    {
+        RenderAreaEffect e = { effect.m_Pos, effect.m_pStats->getRadius(), effect.m_pStats->getSpellType(), effect.m_bNorth };
+        snapshot.m_AreaEffects.push_back(e);
+    }
+}
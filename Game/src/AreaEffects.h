@@ -0,0 +1,82 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "SpellStats.h"
+#include "Vec2.h"
+
+#include <vector>
+
+class DamageBuffer;
+struct RenderSnapshot;
+
+// The spells that have been cast and haven't run out yet.  Once per tick, 
+// after both players have acted, each one finds the entities in its area with
+// a radius query (through Player::findMobsWithin(), so the cost follows how 
+// many are nearby rather than how many there are) and applies its effects:
+//  - damage goes into the DamageBuffer, so it lands along with everyone else's
+//  - pulls move enemy mobs toward the center, swept against the ObstacleField
+//  - haste is applied to our own mobs, and lasts a little past the spell
+// NOTE: Not thread safe.  Spells are cast from the controllers, in the apply
+// phase.
+class AreaEffects
+{
+public:
+    AreaEffects();
+
+    void clear();
+
+    // The spell takes effect at the end of the current tick's apply phase.
+    // Player::castSpell() has already checked (and paid for) it.
+    void cast(const iSpellStats& stats, bool bNorth, const Vec2& pos);
+
+    // Applies every spell for a tick of deltaTSec, then drops the ones that
+    // have run out.
+    void update(float deltaTSec, DamageBuffer& damageBuffer);
+
+    bool empty() const { return m_Effects.empty(); }
+
+    void addToSnapshot(RenderSnapshot& snapshot) const;
+
+private:
+    struct Effect
+    {
+        const iSpellStats* m_pStats;
+        bool m_bNorth;              // who cast it
+        Vec2 m_Pos;
+        float m_TimeLeft;
+        bool m_bLanded;             // the damage has been dealt
+    };
+
+    void applyDamage(const Effect& effect, DamageBuffer& damageBuffer);
+    void applyPull(const Effect& effect, float deltaTSec);
+    void applyHaste(const Effect& effect);
+
+private:
+    std::vector<Effect> m_Effects;
+
+private:
+    // DELIBERATELY UNDEFINED
+    AreaEffects(const AreaEffects& rhs);
+    AreaEffects& operator=(const AreaEffects& rhs);
+};
@@ -20,14 +20,267 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include "AllocTracker.h"
 #include "Building.h"
 #include "Constants.h"
+#include "Controller_AI_KevinDill.h"
 #include "Controller_UI.h"
+#include "FramePacer.h"
 #include "Game.h"
 #include "Graphics.h"
+#include "JobSystem.h"
+#include "PerfOverlay.h"
 #include "Player.h"
+#include "Profiler.h"
+#include "RenderSnapshot.h"
+#include "Sandbox.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Set by the main thread when the window is closed, read by the simulation thread.
+std::atomic<bool> gQuit(false);
+
+struct LaunchOptions
+{
+    enum ControllerType
+    {
+        AI,
+        UI,
+        None,
+    };
+
+    LaunchOptions() 
+        : m_bOffscreen(false)
+        , m_bHeadless(false)
+        , m_bQuiet(false)
+        , m_bSkipAhead(true)
+        , m_CaptureDir(".")
+        , m_CaptureEveryNTicks(0)
+        , m_MaxTicks(0)
+        , m_TickSec(TICK_MIN)
+        , m_NorthController(AI)
+        , m_SouthController(UI)
+        , m_bChooseControllers(false)
+        , m_bSandbox(false)
+        , m_ReportEveryNTicks(0)
+        , m_pProfilePath(NULL)
+        , m_NumThreads(0)
+        , m_TickBudgetMs(TICK_MIN * 1000.f)
+    {}
+
+    bool m_bOffscreen;
+    bool m_bHeadless;
+    bool m_bQuiet;
+    bool m_bSkipAhead;                      // headless only: jump over ticks where nothing can happen
+    std::string m_CaptureDir;
+    int m_CaptureEveryNTicks;
+    std::vector<uint64_t> m_CaptureTicks;
+    uint64_t m_MaxTicks;                    // 0 => run until there's a winner
+    float m_TickSec;                        // offscreen and headless only: game time per tick
+
+    ControllerType m_NorthController;
+    ControllerType m_SouthController;
+    bool m_bChooseControllers;              // false => use the ones the Game picks
+
+    bool m_bSandbox;
+    SandboxOptions m_Sandbox;
+    int m_ReportEveryNTicks;                // 0 => no tick time reports
+
+    const char* m_pProfilePath;             // NULL => don't profile
+    unsigned int m_NumThreads;              // 0 => one per core
+    float m_TickBudgetMs;                   // windowed only, 0 => no fallbacks
+};
+
+// Throws away everything that's written to it.  Used by --quiet, since the
+// entities log every attack and that gets very expensive with lots of units.
+class NullBuffer : public std::streambuf
+{
+protected:
+    virtual int overflow(int c) { return c; }
+};
+
+// Prints the average and worst tick (or frame) time every so often
+class TimeReport
+{
+public:
+    TimeReport(const char* name, int interval) : m_Name(name), m_Interval(interval), m_Count(0), m_TotalMs(0.0), m_MaxMs(0.0) {}
+
+    void add(double ms, size_t numUnits) {
+        if (m_Interval <= 0) {
+            return;
+        }
+
+        m_TotalMs += ms;
+        m_MaxMs = std::max(m_MaxMs, ms);
+        if (++m_Count >= m_Interval) {
+            printf("%s: %d units, avg %.3f ms, max %.3f ms\n", m_Name, (int)numUnits, m_TotalMs / m_Count, m_MaxMs);
+            m_Count = 0;
+            m_TotalMs = 0.0;
+            m_MaxMs = 0.0;
+        }
+    }
+
+private:
+    const char* m_Name;
+    int m_Interval;
+    int m_Count;
+    double m_TotalMs;
+    double m_MaxMs;
+};
+
+void printUsage() {
+    printf("Usage: CrashLoyal [options]\n");
+    printf("  --offscreen             render without a window, as fast as the simulation runs\n");
+    printf("  --headless              don't render at all, just run the simulation as fast as it goes\n");
+    printf("  --capture-dir <dir>     where captured frames are written (default: .)\n");
+    printf("  --capture-every <n>     save a PNG of every nth tick (offscreen only)\n");
+    printf("  --capture-tick <t>      save a PNG of tick t; may be repeated (offscreen only)\n");
+    printf("  --max-ticks <n>         stop after n ticks (offscreen and headless only)\n");
+    printf("  --tick-length <sec>     game time per tick, up to %.2f (offscreen and headless only, default: %.2f)\n", TICK_MAX, TICK_MIN);
+    printf("  --no-skip-ahead         tick through stretches with nothing on the board (headless only)\n");
+    printf("  --north <ai|ui|none>    who controls the North player (default: ai)\n");
+    printf("  --south <ai|ui|none>    who controls the South player (default: ui)\n");
+    printf("  --quiet                 don't log attacks and other game events\n");
+    printf("  --report-every <n>      print tick times every n ticks (default: 20 in the sandbox)\n");
+    printf("  --profile <file>        write a Chrome trace of the run (needs CRASHLOYAL_PROFILER)\n");
+    printf("  --threads <n>           threads for the decide phase of each tick (default: one per core)\n");
+    printf("  --tick-budget <ms>      cut corners on ticks that take longer than this, 0 for never (windowed only, default: %.0f)\n", TICK_MIN * 1000.f);
+    printf("Sandbox (ignores elixir and placement rules):\n");
+    printf("  --sandbox <n>           spawn n units per side at the start\n");
+    printf("  --sandbox-types <list>  comma separated mob names to spawn (default: all of them)\n");
+    printf("  --sandbox-pattern <p>   random, lanes or grid (default: random)\n");
+    printf("  --sandbox-sides <s>     north, south or both (default: both)\n");
+    printf("  --seed <n>              seed for random placement (default: 12345)\n");
+    printf("Keys:\n");
+    printf("  F3                      show or hide the performance overlay\n");
+    printf("  F4                      print the allocation report (needs CRASHLOYAL_ALLOC_TRACKING)\n");
+}
+
+bool parseController(const char* text, LaunchOptions::ControllerType& type) {
+    if (!strcmp(text, "ai")) { type = LaunchOptions::AI; }
+    else if (!strcmp(text, "ui")) { type = LaunchOptions::UI; }
+    else if (!strcmp(text, "none")) { type = LaunchOptions::None; }
+    else { return false; }
+
+    return true;
+}
+
+bool parseArgs(int argc, char* args[], LaunchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = args[i];
+        const char* value = (i + 1 < argc) ? args[i + 1] : NULL;
+
+        if (!strcmp(arg, "--offscreen")) {
+            options.m_bOffscreen = true;
+            continue;
+        }
+        if (!strcmp(arg, "--headless")) {
+            options.m_bHeadless = true;
+            continue;
+        }
+        if (!strcmp(arg, "--quiet")) {
+            options.m_bQuiet = true;
+            continue;
+        }
+        if (!strcmp(arg, "--no-skip-ahead")) {
+            options.m_bSkipAhead = false;
+            continue;
+        }
+
+        if (!value) {
+            printUsage();
+            return false;
+        }
+
+        bool bValid = true;
+        if (!strcmp(arg, "--capture-dir")) {
+            options.m_CaptureDir = value;
+        }
+        else if (!strcmp(arg, "--capture-every")) {
+            options.m_CaptureEveryNTicks = atoi(value);
+        }
+        else if (!strcmp(arg, "--capture-tick")) {
+            options.m_CaptureTicks.push_back(strtoull(value, NULL, 10));
+        }
+        else if (!strcmp(arg, "--max-ticks")) {
+            options.m_MaxTicks = strtoull(value, NULL, 10);
+        }
+        else if (!strcmp(arg, "--north")) {
+            bValid = parseController(value, options.m_NorthController);
+            options.m_bChooseControllers = true;
+        }
+        else if (!strcmp(arg, "--south")) {
+            bValid = parseController(value, options.m_SouthController);
+            options.m_bChooseControllers = true;
+        }
+        else if (!strcmp(arg, "--profile")) {
+            options.m_pProfilePath = value;
+        }
+        else if (!strcmp(arg, "--threads")) {
+            options.m_NumThreads = (unsigned int)std::max(0, atoi(value));
+        }
+        else if (!strcmp(arg, "--tick-length")) {
+            options.m_TickSec = std::min(std::max((float)atof(value), TICK_MIN), TICK_MAX);
+        }
+        else if (!strcmp(arg, "--tick-budget")) {
+            options.m_TickBudgetMs = std::max(0.f, (float)atof(value));
+        }
+        else if (!strcmp(arg, "--report-every")) {
+            options.m_ReportEveryNTicks = atoi(value);
+        }
+        else if (!strcmp(arg, "--sandbox")) {
+            options.m_bSandbox = true;
+            options.m_Sandbox.m_NumUnitsPerSide = atoi(value);
+        }
+        else if (!strcmp(arg, "--sandbox-types")) {
+            bValid = Sandbox::parseTypes(value, options.m_Sandbox.m_Types);
+        }
+        else if (!strcmp(arg, "--sandbox-pattern")) {
+            bValid = Sandbox::parsePattern(value, options.m_Sandbox.m_Pattern);
+        }
+        else if (!strcmp(arg, "--sandbox-sides")) {
+            bValid = Sandbox::parseSides(value, options.m_Sandbox);
+        }
+        else if (!strcmp(arg, "--seed")) {
+            options.m_Sandbox.m_Seed = (unsigned int)strtoul(value, NULL, 10);
+        }
+        else {
+            bValid = false;
+        }
+
+        if (!bValid) {
+            printUsage();
+            return false;
+        }
+        ++i;
+    }
+
+    if (options.m_bSandbox && (options.m_ReportEveryNTicks == 0)) {
+        options.m_ReportEveryNTicks = 20;
+    }
+
+    return true;
+}
+
+iController* makeController(LaunchOptions::ControllerType type) {
+    switch (type) {
+    case LaunchOptions::AI: return new Controller_AI_KevinDill;
+    case LaunchOptions::UI: return new Controller_UI;
+    default: return NULL;
+    }
+}
+
+size_t countUnits() {
+    Game& game = Game::get();
+    return game.getPlayer(true).getMobs().size() + game.getPlayer(false).getMobs().size();
+}
 
 bool init() {
     return true;
@@ -41,85 +294,266 @@ void close() {
     SDL_Quit();
 }
 
-int main(int argc, char* args[]) {
+// The simulation runs on its own thread.  After every tick it publishes a
+// snapshot of the game for the renderer, which picks up the newest one at its
+// own pace - so a slow frame doesn't hold up the game, and vice versa.
+// If a tick takes longer than tickBudgetMs, the game falls back to cheaper
+// (and less accurate) ways of doing things until it catches up.
+void runSimulation(SnapshotBuffer* pSnapshots, int reportEveryNTicks, float tickBudgetMs) {
     Game& game = Game::get();
+    TimeReport tickReport("Tick", reportEveryNTicks);
+    Profiler::get().setThreadName("Simulation");
+    game.getTickBudget().setBudgetMs(tickBudgetMs);
+
+    // Sleep until at least TICK_MIN has passed, rather than spinning on the clock
+    FramePacer pacer(TICK_MIN);
+
+    while (!gQuit) {
+        float deltaTSec = pacer.waitForNextFrame();
+
+        // Once there's a winner nothing changes any more, so stop ticking and
+        // just wake up now and then to see if it's time to quit.
+        if (game.checkGameOver() != 0)
+            continue;
+
+        if (deltaTSec > TICK_MAX)
+        {
+            std::cout << "Tick duration over budget: " << deltaTSec << std::endl;
+            game.getTickBudget().addDroppedTime(deltaTSec - TICK_MAX);
+            deltaTSec = TICK_MAX;
+        }
+
+        // TICK 
+        std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+        game.tick(deltaTSec);
+        tickReport.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart).count(), countUnits());
+
+        game.buildSnapshot(pSnapshots->beginWrite());
+        pSnapshots->publish();
+    }
+}
+
+// The most ticks runHeadless() will skip in one go
+static const uint64_t kMaxSkipTicks = 1200;
+
+// With no window there's nothing to keep in step with, so the game is ticked
+// at a fixed tick length as fast as it will go.  That's TICK_MIN unless 
+// --tick-length asks for longer ones, which get through a match in fewer 
+// ticks; movement is swept, so nothing goes through walls or other units.
+// When rendering offscreen, only the frames that are being captured are drawn
+// at all, plus the final one.
+void runHeadless(const LaunchOptions& options) {
+    Game& game = Game::get();
+    Graphics* pGraphics = options.m_bOffscreen ? &Graphics::get() : NULL;
+    TimeReport tickReport("Tick", options.m_ReportEveryNTicks);
+
+    if (pGraphics) {
+        pGraphics->setCapture(options.m_CaptureDir, options.m_CaptureEveryNTicks, options.m_CaptureTicks);
+    }
+
+    // Skipping would jump over ticks that the offscreen renderer might want
+    // to capture, so it's only done when we aren't drawing at all.
+    bool bSkipAhead = options.m_bSkipAhead && !pGraphics;
+    uint64_t numSkipped = 0;
+
+    RenderSnapshot snapshot;
+    while ((game.checkGameOver() == 0) && ((options.m_MaxTicks == 0) || (game.getTickCount() < options.m_MaxTicks))) {
+        if (bSkipAhead) {
+            // A limit on each jump, so that a match with nobody playing still 
+            // comes back around the loop now and then.
+            uint64_t maxSkip = (options.m_MaxTicks > 0) ? (options.m_MaxTicks - game.getTickCount()) : kMaxSkipTicks;
+            int numTicks = game.skipQuietTicks(options.m_TickSec, (int)std::min<uint64_t>(maxSkip, kMaxSkipTicks));
+            if (numTicks > 0) {
+                numSkipped += numTicks;
+                continue;
+            }
+        }
+
+        std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+        game.tick(options.m_TickSec);
+        tickReport.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart).count(), countUnits());
+
+        if (pGraphics && pGraphics->wantsCapture(game.getTickCount())) {
+            game.buildSnapshot(snapshot);
+            pGraphics->resetFrame();
+            pGraphics->drawSnapshot(snapshot);
+            pGraphics->render();
+        }
+    }
+
+    // Always finish with a picture of how the game ended
+    if (pGraphics && !pGraphics->wantsCapture(game.getTickCount())) {
+        pGraphics->addCaptureTick(game.getTickCount());
+        game.buildSnapshot(snapshot);
+        pGraphics->resetFrame();
+        pGraphics->drawSnapshot(snapshot);
+        pGraphics->render();
+    }
+
+    printf("Run finished after %llu ticks, %llu of them skipped (game over state %d).\n",
+        (unsigned long long)game.getTickCount(), (unsigned long long)numSkipped, game.checkGameOver());
+
+    if (pGraphics) {
+        pGraphics->endCapture();
+    }
+}
+
+void handleEvent(const SDL_Event& e, PerfOverlay& perfOverlay, bool& quit, bool& redraw) {
     Graphics& graphics = Graphics::get();
 
+    if (e.type == SDL_QUIT) { quit = true; }
+    if ((e.type == SDL_KEYDOWN) && (e.key.keysym.sym == SDLK_F3) && !e.key.repeat) {
+        perfOverlay.toggle();
+        redraw = true;
+    }
+    if ((e.type == SDL_KEYDOWN) && (e.key.keysym.sym == SDLK_F4) && !e.key.repeat) {
+        AllocTracker::writeReport(stdout);
+    }
+    if ((e.type == SDL_RENDER_TARGETS_RESET) || (e.type == SDL_RENDER_DEVICE_RESET) ||
+        ((e.type == SDL_WINDOWEVENT) && (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED))) {
+        graphics.invalidateStaticLayer();
+        redraw = true;
+    }
+    if ((e.type == SDL_WINDOWEVENT) && 
+        ((e.window.event == SDL_WINDOWEVENT_EXPOSED) || (e.window.event == SDL_WINDOWEVENT_RESTORED))) {
+        redraw = true;
+    }
+    if (Controller_UI::exists()) {
+        Controller_UI::get().loadEvent(e);
+    }
+}
+
+int main(int argc, char* args[]) {
+    LaunchOptions options;
+    if (!parseArgs(argc, args, options)) {
+        return 1;
+    }
+
+    NullBuffer nullBuffer;
+    std::streambuf* pCoutBuffer = std::cout.rdbuf();
+    if (options.m_bQuiet) {
+        std::cout.rdbuf(&nullBuffer);
+    }
+
+    // Set up before any other threads start, since Singleton::get() isn't thread safe
+    Profiler& profiler = Profiler::get();
+    profiler.setThreadName("Main");
+    if (options.m_pProfilePath) {
+        if (Profiler::isCompiledIn()) {
+            profiler.setEnabled(true);
+        }
+        else {
+            printf("--profile ignored: build with CRASHLOYAL_PROFILER defined to profile.\n");
+        }
+    }
+
+    JobSystem::get().setNumThreads(options.m_NumThreads);
+
+    Graphics::setOffscreen(options.m_bOffscreen);
+
+    Game& game = Game::get();
+    if (options.m_bChooseControllers || options.m_bSandbox) {
+        game.startMatch(makeController(options.m_NorthController), makeController(options.m_SouthController));
+    }
+    if (options.m_bSandbox) {
+        Sandbox::spawn(options.m_Sandbox);
+    }
+
     //Start up SDL and create window
     if (!init()) {
         printf("Failed to initialize!\n");
     }
+    else if (options.m_bOffscreen || options.m_bHeadless) {
+        runHeadless(options);
+    }
     else {
-        using namespace std::chrono;
-        high_resolution_clock::time_point prevTime = high_resolution_clock::now();
+        Graphics& graphics = Graphics::get();
+        TimeReport frameReport("Frame", options.m_ReportEveryNTicks);
+
+        // Publish the starting state, so there's something to draw before the first tick
+        SnapshotBuffer snapshots;
+        game.buildSnapshot(snapshots.beginWrite());
+        snapshots.publish();
+
+        // NOTE: SDL wants rendering and event handling done on the thread that 
+        // created the window, so it's the simulation that gets its own thread.
+        std::thread simThread(runSimulation, &snapshots, options.m_ReportEveryNTicks, options.m_TickBudgetMs);
+
+        // Only used if we didn't get vsync - otherwise presenting paces us
+        FramePacer framePacer(FRAME_TIME);
+
+        // F3 toggles it
+        PerfOverlay perfOverlay;
 
         bool quit = false;
+        bool redraw = false;
         SDL_Event e;
         while (!quit) {
-            // Get the elapsed time, and ensure it's at between TICK_MIN and TICK_MAX
-            high_resolution_clock::time_point now = high_resolution_clock::now();
-            double deltaTSec = (float)duration_cast<milliseconds>(now - prevTime).count() / 1000;
-
-            if (deltaTSec > TICK_MAX)
-            {
-                std::cout << "Tick duration over budget: " << deltaTSec << std::endl;
-                deltaTSec = TICK_MAX;
+            // When nothing on screen can change (the window is hidden, or the 
+            // win screen is already up) block on the event queue instead.
+            bool idle = !graphics.isWindowVisible() || ((snapshots.getCurrent().m_GameOverState != 0) && !redraw);
+            if (idle && SDL_WaitEventTimeout(&e, IDLE_WAIT_MS)) {
+                handleEvent(e, perfOverlay, quit, redraw);
             }
 
-            if (deltaTSec < TICK_MIN)
-                continue;
-
-            prevTime = now;
-
-            graphics.resetFrame();
-
             // Handle UI events - quit if appropriate, otherwise, pass them on to the UI controller (if any)
             while (SDL_PollEvent(&e) != 0) {
-                if (e.type == SDL_QUIT) { quit = true; }
-                if (Controller_UI::exists()) {
-                    Controller_UI::get().loadEvent(e);
-                }
+                handleEvent(e, perfOverlay, quit, redraw);
             }
 
-            // TICK 
-            game.tick((float)deltaTSec);
-
-            // RENDER
-            Player& northPlayer = game.getPlayer(true);
-            Player& southPlayer = game.getPlayer(false);
-
-            for (Entity* pBuilding : northPlayer.getBuildings()) {
-                graphics.drawBuilding(pBuilding);
-            }
+            // Only redraw when the simulation has something new for us, or the
+            // window needs repainting.
+            bool presented = false;
+            const RenderSnapshot* pSnapshot = snapshots.acquireLatest();
+            if (graphics.isWindowVisible()) {
+                if (pSnapshot || redraw) {
+                    // RENDER
+                    PROFILE_SCOPE("Frame");
+                    std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+                    graphics.resetFrame();
+                    graphics.drawSnapshot(snapshots.getCurrent());
+                    graphics.flushBatches();
+                    double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+                    frameReport.add(frameMs, snapshots.getCurrent().m_Mobs.size());
 
-            for (Entity* pBuilding : southPlayer.getBuildings()) {
-                graphics.drawBuilding(pBuilding);
-            }
+                    // NOTE: The overlay is drawn after the frame is timed, so
+                    // turning it on doesn't change the numbers it shows.
+                    if (pSnapshot) {
+                        perfOverlay.addTickSample(pSnapshot->m_Stats.m_TickMs);
+                    }
+                    perfOverlay.addFrameSample((float)frameMs);
+                    graphics.drawPerfOverlay(perfOverlay, snapshots.getCurrent());
 
-            for (Entity* m : northPlayer.getMobs()) {
-                if (!m->isDead()) {
-                    graphics.drawMob(m);
+                    graphics.render();
+                    presented = true;
+                    redraw = false;
                 }
             }
+            else if (pSnapshot) {
+                redraw = true;
+            }
 
-            for (Entity* m : southPlayer.getMobs()) {
-                if (!m->isDead()) {
-                    graphics.drawMob(m);
-                }
+            if (!idle && !(presented && graphics.hasVSync())) {
+                framePacer.waitForNextFrame();
             }
+        }
 
-            // Draw the elixir values:
-            graphics.drawElixir(northPlayer.getElixir(), southPlayer.getElixir());
+        gQuit = true;
+        simThread.join();
 
-            // If there is a winner, draw the message to the screen
-            graphics.drawWinScreen(game.checkGameOver());
+        game.getTickBudget().writeReport(stdout);
+    }
 
-            graphics.render();
-        }
+    if (profiler.isEnabled()) {
+        profiler.setEnabled(false);
+        profiler.writeChromeTrace(options.m_pProfilePath);
+    }
 
+    if (AllocTracker::isCompiledIn()) {
+        AllocTracker::writeReport(stdout);
     }
 
+    std::cout.rdbuf(pCoutBuffer);
     close();
     return 0;
 }
-
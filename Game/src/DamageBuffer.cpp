@@ -0,0 +1,73 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DamageBuffer.h"
+
+#include "Building.h"
+#include "Entity.h"
+#include "EntityRegistry.h"
+#include "Game.h"
+#include "Player.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <stdio.h>
+
+int DamageBuffer::resolve(const EntityRegistry& registry)
+{
+    PROFILE_SCOPE("DamageBuffer::resolve");
+
+    int numKilled = 0;
+    for (const Record& record : m_Records)
+    {
+        // Nothing is freed until the damage has been resolved, so the target
+        // can only be gone if it was freed by something outside the tick.
+        Entity* pTarget = registry.get(record.m_Target);
+        if (!pTarget || pTarget->isDead())
+            continue;
+
+        pTarget->takeDamage(record.m_Amount);
+        if (pTarget->isDead())
+        {
+            ++numKilled;
+            Game& game = Game::get();
+            game.getPlayer(pTarget->isNorth()).invalidatePackedPositions();
+            game.getEventGrid().addEvent(pTarget->isNorth(), pTarget->getCell());
+            if (dynamic_cast<Building*>(pTarget))
+            {
+                game.getObstacleField().removeTower(pTarget->getPosition());
+            }
+
+            Entity* pAttacker = registry.get(record.m_Attacker);
+            char buff[200];
+            snprintf(buff, 200, "%s %s killed %s %s.\n",
+                     pTarget->isNorth() ? "South" : "North",
+                     pAttacker ? pAttacker->getStats().getName() : "(unknown)",
+                     pTarget->isNorth() ? "North" : "South",
+                     pTarget->getStats().getName());
+            std::cout << buff;
+        }
+    }
+
+    m_Records.clear();
+    return numKilled;
+}
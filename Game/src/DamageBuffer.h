@@ -0,0 +1,68 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EntityHandle.h"
+
+#include <stddef.h>
+#include <vector>
+
+class EntityRegistry;
+
+// The attacks made during a tick.  Rather than hurting their targets right
+// away, entities record their attacks here, and Game applies them all at once
+// after everyone has acted.  So nothing dies partway through a tick, and 
+// ticking North before South no longer lets North kill units before they get
+// their attack in.
+// NOTE: add() isn't thread safe.  Attacks happen in the apply phase, which is
+// single threaded.
+class DamageBuffer
+{
+public:
+    struct Record
+    {
+        EntityHandle m_Attacker;
+        EntityHandle m_Target;
+        int m_Amount;
+    };
+
+    void add(EntityHandle attacker, EntityHandle target, int amount)
+    {
+        Record record = { attacker, target, amount };
+        m_Records.push_back(record);
+    }
+
+    size_t size() const { return m_Records.size(); }
+    bool empty() const { return m_Records.empty(); }
+    const std::vector<Record>& getRecords() const { return m_Records; }
+
+    // Applies every record and empties the buffer (keeping its memory).  
+    // Damage just adds up, so the order doesn't matter.  Returns how many 
+    // entities were killed.
+    int resolve(const EntityRegistry& registry);
+
+    void clear() { m_Records.clear(); }
+
+private:
+    std::vector<Record> m_Records;
+};
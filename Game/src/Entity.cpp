@@ -23,24 +23,116 @@
 #include "Entity.h"
 
 #include "Building.h"
+#include "Constants.h"
+#include "EventGrid.h"
 #include "Game.h"
 #include "Mob.h"
 #include "Player.h"
+#include "Profiler.h"
+#include "SimStats.h"
+#include "SpatialKernels.h"
 
 Entity::Entity(const iEntityStats &stats, const Vec2 &pos, bool isNorth)
-        : m_Stats(stats), m_bNorth(isNorth), m_Health(stats.getMaxHealth()), m_Pos(pos), m_pTarget(NULL),
-          m_bTargetLock(NULL), m_TimeSinceAttack(0.f), m_hiddenTime(0.f), m_chargeSpringAttack(false) {
+        : m_Stats(stats), m_bNorth(isNorth), m_Health(stats.getMaxHealth()), m_Pos(pos), m_Target(),
+          m_bTargetLock(false), m_DecisionTick(UINT64_MAX), m_Cell(EventGrid::getCell(pos)), m_bHasTargetPick(false),
+          m_TargetPickCell(0), m_TargetPickEvents(0), m_bAttackReady(false), m_HasteMultiplier(1.f), m_HasteEndTime(0.0),
+          m_bHiding(false), m_bInvisible(false), m_HidingStretch(0), m_chargeSpringAttack(false) {
 }
 
-void Entity::tick(float deltaTSec) {
+void Entity::onSpawned() {
+    assert(!m_Handle.isNull());
+
+    // The cooldown starts with the first tick we take part in, which is the 
+    // current one if we were spawned during a tick
+    Game &game = Game::get();
+    game.scheduleTimer(game.getTickStartTime() + m_Stats.getAttackTime(), m_Handle, AttackReadyTimer);
+    game.getEventGrid().addEvent(m_bNorth, m_Cell);
+}
+
+void Entity::applyHaste(float multiplier, double endTime) {
+    if (getHasteMultiplier() > multiplier) {
+        return;
+    }
+
+    m_HasteMultiplier = multiplier;
+    m_HasteEndTime = std::max(m_HasteEndTime, endTime);
+}
+
+float Entity::getHasteMultiplier() const {
+    return (Game::get().getSimTime() < m_HasteEndTime) ? m_HasteMultiplier : 1.f;
+}
+
+void Entity::updateCell() {
+    int cell = EventGrid::getCell(m_Pos);
+    if (cell != m_Cell) {
+        Game::get().getEventGrid().addMove(m_bNorth, m_Cell, cell);
+        m_Cell = cell;
+    }
+}
+
+void Entity::onTimer(int type, uint32_t data) {
+    switch (type) {
+        case AttackReadyTimer:
+            m_bAttackReady = true;
+            break;
+
+        case HiddenLongEnoughTimer:
+            // Only count it if we've been hiding ever since it was scheduled
+            if (m_bHiding && (data == m_HidingStretch)) {
+                m_bInvisible = true;
+            }
+            break;
+
+        default:
+            assert(false);
+            break;
+    }
+}
+
+void Entity::startHiding() {
+    if (m_bHiding)
+        return;
+
+    // The tick we start hiding in counts toward the time
+    m_bHiding = true;
+    ++m_HidingStretch;
+    Game &game = Game::get();
+    game.scheduleTimer(game.getTickStartTime() + ROGUE_HIDE_TIME, m_Handle, HiddenLongEnoughTimer, m_HidingStretch);
+}
+
+void Entity::stopHiding() {
+    if (!m_bHiding)
+        return;
+
+    m_bHiding = false;
+    m_bInvisible = false;
+    ++m_HidingStretch;
+}
+
+void Entity::decide() {
+    pickTarget();
+    m_DecisionTick = Game::get().getTickCount();
+}
+
+bool Entity::hasDecided() const {
+    return m_DecisionTick == Game::get().getTickCount();
+}
+
+void Entity::tick(float /*deltaTSec*/) {
     // Project 2: You may need to do something special here to change the way the Rogue
     // does damage, or how much damage it does (among other things).
 
-    pickTarget();
-    m_TimeSinceAttack += deltaTSec;
+    // Our target was picked in the decide phase, unless we've spawned or it
+    // has died since.
+    Entity* pDecided = getTarget();
+    if (!hasDecided() || (!m_Target.isNull() && (!pDecided || pDecided->isDead()))) {
+        pickTarget();
+    }
 
+    Entity* pTarget = getTarget();
 
-    if (targetInRange() && (m_TimeSinceAttack > m_Stats.getAttackTime())) {
+    // Until our cooldown timer fires there's nothing to check
+    if (m_bAttackReady && targetInRange()) {
         int damage = int(m_Stats.getDamage());
 
         if (m_Stats.getName() == "Rogue" && m_chargeSpringAttack) {
@@ -56,72 +148,124 @@ void Entity::tick(float deltaTSec) {
         snprintf(buff, 200, "%s %s attacks %s %s for %d damage.\n",
                  m_bNorth ? "North" : "South",
                  m_Stats.getName(),
-                 m_pTarget->isNorth() ? "North" : "South",
-                 m_pTarget->getStats().getName(),
+                 pTarget->isNorth() ? "North" : "South",
+                 pTarget->getStats().getName(),
                  damage);
         std::cout << buff;
 
+        // The damage lands at the end of the tick, along with everyone else's.
+        // Ranged attacks land once the shot gets there, unless there are so 
+        // many in flight that there's no room for it.
         m_bTargetLock = true;
-        m_pTarget->takeDamage(damage);
-        m_TimeSinceAttack = 0.f;
+        Game &game = Game::get();
+        bool bFired = (m_Stats.getDamageType() == iEntityStats::Ranged) &&
+                      game.getProjectiles().fire(m_Handle, pTarget->getHandle(), m_bNorth, m_Pos, pTarget->getPosition(), damage);
+        if (bFired) {
+            SimStats::get().count(SimStats::ProjectilesFired);
+        } else {
+            game.getDamageBuffer().add(m_Handle, pTarget->getHandle(), damage);
+        }
+        m_bAttackReady = false;
+        game.scheduleTimer(game.getSimTime() + (m_Stats.getAttackTime() / getHasteMultiplier()), m_Handle, AttackReadyTimer);
     }
 }
 
 void Entity::pickTarget() {
-    assert(!m_bTargetLock || !!m_pTarget);
-    if (m_bTargetLock && !m_pTarget->isDead()) {
+    PROFILE_SCOPE("Entity::pickTarget");
+    ScopedSimTimer timer(SimStats::PickTarget);
+
+    assert(!m_bTargetLock || !m_Target.isNull());
+
+    // If our locked target has been freed, its handle will have gone stale.
+    Entity* pLocked = m_bTargetLock ? getTarget() : NULL;
+    if (pLocked && !pLocked->isDead()) {
         return;
     }
 
-    m_pTarget = NULL;
     m_bTargetLock = false;
+    if (isTargetPickCurrent()) {
+        return;
+    }
+
+    m_Target = EntityHandle();
 
     Game &game = Game::get();
+    SimStats::get().count(SimStats::SpatialQueries);
+
+    // Remember what we saw, so we can tell when it's worth looking again
+    m_bHasTargetPick = true;
+    m_TargetPickCell = m_Cell;
+    m_TargetPickEvents = game.getEventGrid().sumEvents(!m_bNorth, m_Cell, m_Stats.getSightRadius());
 
     // we only attack things that are within our sight radius
     float closestDist = getStats().getSightRadius();
     float closestDistSq = closestDist * closestDist;
 
-    Player &opposingPlayer = Game::get().getPlayer(!m_bNorth);
-
+    Player &opposingPlayer = game.getPlayer(!m_bNorth);
 
+    // The packs only hold live entities.  Buildings are checked first, and
+    // mobs have to be strictly closer to win, so a building wins a tie.
     if (m_Stats.getTargetType() != iEntityStats::Mob) {
-        for (Entity *pEntity: opposingPlayer.getBuildings()) {
-            assert(pEntity->isNorth() != isNorth());
-            if (!pEntity->isDead()) {
-                float distSq = m_Pos.distSqr(pEntity->getPosition());
-                if (distSq < closestDistSq) {
-                    closestDistSq = distSq;
-                    m_pTarget = pEntity;
-                }
-            }
+        const PackedPositions &buildings = opposingPlayer.getPackedBuildings();
+        int i = SpatialKernels::findNearestWithin(buildings, m_Pos, closestDistSq, &closestDistSq);
+        if (i >= 0) {
+            assert(buildings.m_Entities[i]->isNorth() != isNorth());
+            m_Target = buildings.m_Entities[i]->getHandle();
         }
     }
 
     if (m_Stats.getTargetType() != iEntityStats::Building) {
-        for (Entity *pEntity: opposingPlayer.getMobs()) {
-            assert(pEntity->isNorth() != isNorth());
-            if (!pEntity->isDead()) {
-                float distSq = m_Pos.distSqr(pEntity->getPosition());
-                if (distSq < closestDistSq) {
-                    closestDistSq = distSq;
-                    m_pTarget = pEntity;
-                }
-            }
+        const PackedPositions &mobs = opposingPlayer.getPackedMobs();
+        int i = SpatialKernels::findNearestWithin(mobs, m_Pos, closestDistSq, &closestDistSq);
+        if (i >= 0) {
+            assert(mobs.m_Entities[i]->isNorth() != isNorth());
+            m_Target = mobs.m_Entities[i]->getHandle();
+        }
+    }
+}
+
+bool Entity::isTargetPickCurrent() const {
+    if (!m_bHasTargetPick) {
+        return false;
+    }
+
+    // A pick of nothing stays good until an enemy turns up nearby, which the 
+    // EventGrid will see.
+    Game &game = Game::get();
+    float sightRadius = m_Stats.getSightRadius();
+    if (!m_Target.isNull()) {
+        Entity* pTarget = getTarget();
+        if (!pTarget || pTarget->isDead() ||
+            (m_Pos.distSqr(pTarget->getPosition()) >= sightRadius * sightRadius)) {
+            return false;
+        }
+
+        // Over budget, we'll settle for a target that's still good, even if
+        // something closer might have come along.
+        if (game.getTickBudget().isActive(TickBudget::ReuseTargets)) {
+            return true;
         }
     }
+
+    return (m_Cell == m_TargetPickCell) &&
+           (game.getEventGrid().sumEvents(!m_bNorth, m_Cell, sightRadius) == m_TargetPickEvents);
 }
 
 bool Entity::targetInRange() {
-    if (!!m_pTarget) {
+    Entity* pTarget = getTarget();
+    if (!!pTarget) {
         float range = m_Stats.getAttackRange();
 
         if (m_Stats.getDamageType() == iEntityStats::Melee) {
-            range += ((m_Stats.getSize() + m_pTarget->getStats().getSize()) / 2.f);
+            range += ((m_Stats.getSize() + pTarget->getStats().getSize()) / 2.f);
         }
 
-        return m_Pos.distSqr(m_pTarget->getPosition()) <= (range * range);
+        return m_Pos.distSqr(pTarget->getPosition()) <= (range * range);
     }
 
     return false;
 }
+
+Entity* Entity::getTarget() const {
+    return Game::get().getRegistry().get(m_Target);
+}
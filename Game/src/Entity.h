@@ -22,12 +22,14 @@
 
 #pragma once
 
+#include "EntityHandle.h"
 #include "EntityStats.h"
 #include "iPlayer.h"
 #include "Vec2.h"
 
 class Entity 
 {
+    friend class EntityRegistry;
 
 public:
     Entity(const iEntityStats& stats, const Vec2& pos, bool isNorth);
@@ -35,8 +37,32 @@ public:
 
     virtual const iEntityStats& getStats() const { return m_Stats; }
 
+    // The sense/decide phase of a tick, which picks our target based on where
+    // everything was at the start of the tick.  Game runs it for every live
+    // entity on both sides before either player ticks, spread across the
+    // JobSystem's threads.  So it must only read other entities, and only 
+    // write to our own decision state.
+    virtual void decide();
+
+    // The apply phase: attack, move, collide.  This runs one entity at a time,
+    // in the same order every tick.
     virtual void tick(float deltaTSec);
 
+    // Timers we schedule with Game::scheduleTimer()
+    enum TimerType
+    {
+        AttackReadyTimer,           // our attack cooldown is up
+        HiddenLongEnoughTimer,      // Rogues: hidden for ROGUE_HIDE_TIME, data is the hiding stretch
+    };
+
+    // Schedules the timers every entity starts with, and records our arrival
+    // in the EventGrid.  Call this once the entity has been added to the 
+    // registry.
+    void onSpawned();
+
+    // Called by Game when one of our timers comes due.
+    virtual void onTimer(int type, uint32_t data);
+
     virtual bool isNorth() const { return m_bNorth; }
 
     virtual bool isDead() const { return m_Health <= 0; }
@@ -49,29 +75,82 @@ public:
     // not be rendered at all if they belong to the North player.
     virtual bool isHidden() const { return false; }
 
-    iPlayer::EntityData getData() const { return iPlayer::EntityData(m_Stats, m_Health, m_Pos); }
+    // Our cell in the EventGrid, as of the last time we moved
+    int getCell() const { return m_Cell; }
+
+    // The handle is null until the entity is added to the Game's EntityRegistry
+    EntityHandle getHandle() const { return m_Handle; }
 
-    virtual bool isInvisible() {
-        return m_hiddenTime >= 2.f;
+    iPlayer::EntityData getData() const { return iPlayer::EntityData(m_Stats, m_Health, m_Pos, m_Handle); }
+
+    // True once a Rogue has stayed hidden for ROGUE_HIDE_TIME
+    virtual bool isInvisible() const {
+        return m_bInvisible;
     }
 
+    // Spells: we move and attack multiplier times as fast until endTime (in
+    // sim time).  A weaker or shorter haste doesn't cut a stronger one short.
+    void applyHaste(float multiplier, double endTime);
+
+    // 1 unless we're hasted
+    float getHasteMultiplier() const;
+
 
 protected:
+    // Picks the closest enemy in sight, unless our target is locked or the
+    // last pick is still good.
     void pickTarget();
     bool targetInRange();
 
+    // Our last pick stays good until we change cells, our target dies or 
+    // leaves our sight, or the EventGrid sees something happen to an enemy
+    // near us.
+    bool isTargetPickCurrent() const;
+
+    // Call after moving, to let the EventGrid know if we've changed cells
+    void updateCell();
+
+    // True if decide() has run for us this tick.  It won't have if we were
+    // spawned after the decide phase.
+    bool hasDecided() const;
+
+    // Rogues: starting to hide schedules the timer that will turn us 
+    // invisible, and stopping cancels it.
+    void startHiding();
+    void stopHiding();
+
+    // Resolves m_Target.  Returns NULL if we have no target, or if our target
+    // has been freed since we picked it.
+    Entity* getTarget() const;
+
 protected:
     const iEntityStats& m_Stats;
     bool m_bNorth;
     int m_Health;
     Vec2 m_Pos;
+    EntityHandle m_Handle;
 
     // Our target will be the closest target (may change every tick) until
     //  we attack it.  Once we attack a target, we stay locked on it until
     //  it dies
-    Entity* m_pTarget;
+    EntityHandle m_Target;
     bool m_bTargetLock;
-    float m_TimeSinceAttack;
-    float m_hiddenTime;
+    uint64_t m_DecisionTick;        // the tick we last ran decide() on
+    int m_Cell;                     // see getCell()
+
+    // What pickTarget() saw when it last looked around.  See isTargetPickCurrent().
+    bool m_bHasTargetPick;
+    int m_TargetPickCell;
+    uint64_t m_TargetPickEvents;
+
+    bool m_bAttackReady;            // set by our AttackReadyTimer, cleared when we attack
+
+    float m_HasteMultiplier;        // see applyHaste()
+    double m_HasteEndTime;
+
+    // Rogues only
+    bool m_bHiding;                 // hidden since some tick, but maybe not for long enough
+    bool m_bInvisible;              // hidden for at least ROGUE_HIDE_TIME
+    uint32_t m_HidingStretch;       // bumped whenever we start or stop hiding, so stale timers can be spotted
     bool m_chargeSpringAttack;
 };
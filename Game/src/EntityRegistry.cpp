@@ -0,0 +1,88 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "EntityRegistry.h"
+
+#include "Entity.h"
+#include <assert.h>
+
+EntityRegistry::EntityRegistry()
+{
+}
+
+EntityHandle EntityRegistry::add(Entity* pEntity)
+{
+    assert(pEntity);
+    assert(pEntity->getHandle().isNull());
+
+    uint32_t index;
+    if (!m_FreeSlots.empty())
+    {
+        index = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)m_Slots.size();
+        assert(index <= EntityHandle::kMaxIndex);
+
+        Slot slot = { NULL, 1 };
+        m_Slots.push_back(slot);
+    }
+
+    Slot& slot = m_Slots[index];
+    assert(!slot.m_pEntity);
+    slot.m_pEntity = pEntity;
+
+    EntityHandle h(index, slot.m_Generation);
+    pEntity->m_Handle = h;
+    return h;
+}
+
+void EntityRegistry::remove(EntityHandle h)
+{
+    Entity* pEntity = get(h);
+    if (!pEntity)
+        return;
+
+    pEntity->m_Handle = EntityHandle();
+
+    // Bump the generation so that outstanding handles go stale.  Generation 0
+    // is reserved for the null handle, so skip it when we wrap.
+    Slot& slot = m_Slots[h.getIndex()];
+    slot.m_pEntity = NULL;
+    slot.m_Generation = (slot.m_Generation % EntityHandle::kMaxGeneration) + 1;
+    m_FreeSlots.push_back(h.getIndex());
+}
+
+void EntityRegistry::clear()
+{
+    // Keep the slots (and their generations) around rather than dropping them,
+    // so that a handle from before the clear can never alias a new entity.
+    for (size_t i = 0; i < m_Slots.size(); ++i)
+    {
+        if (m_Slots[i].m_pEntity)
+        {
+            remove(EntityHandle((uint32_t)i, m_Slots[i].m_Generation));
+        }
+    }
+}
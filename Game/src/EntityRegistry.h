@@ -0,0 +1,72 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EntityHandle.h"
+
+#include <stddef.h>
+#include <vector>
+
+class Entity;
+
+// Owns the mapping from EntityHandles to live entities.  Slots are recycled
+// once an entity is removed, with the slot's generation bumped so that any 
+// outstanding handles to the old entity go stale.
+class EntityRegistry
+{
+public:
+    EntityRegistry();
+
+    // Assigns a new handle to the entity, and stores it on the entity.
+    EntityHandle add(Entity* pEntity);
+
+    // Frees the entity's slot.  The entity itself is NOT deleted.
+    void remove(EntityHandle h);
+
+    // Returns NULL if the handle is null or stale.
+    Entity* get(EntityHandle h) const
+    {
+        if (h.isNull() || (h.getIndex() >= m_Slots.size()))
+            return NULL;
+
+        const Slot& slot = m_Slots[h.getIndex()];
+        return (slot.m_Generation == h.getGeneration()) ? slot.m_pEntity : NULL;
+    }
+
+    bool isValid(EntityHandle h) const { return get(h) != NULL; }
+
+    size_t getNumSlots() const { return m_Slots.size(); }
+
+    // Frees every slot.  Used when the players are rebuilt.
+    void clear();
+
+private:
+    struct Slot
+    {
+        Entity* m_pEntity;              // NOT owned, NULL when the slot is free
+        uint32_t m_Generation;
+    };
+
+    std::vector<Slot> m_Slots;
+    std::vector<uint32_t> m_FreeSlots;
+};
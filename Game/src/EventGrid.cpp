@@ -0,0 +1,91 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "EventGrid.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+EventGrid::EventGrid()
+{
+    clear();
+}
+
+void EventGrid::clear()
+{
+    memset(m_RowTotals, 0, sizeof(m_RowTotals));
+}
+
+int EventGrid::getCell(const Vec2& pos)
+{
+    int x = (int)floorf(pos.x);
+    int y = (int)floorf(pos.y);
+    x = (x < 0) ? 0 : ((x >= kWidth) ? (kWidth - 1) : x);
+    y = (y < 0) ? 0 : ((y >= kHeight) ? (kHeight - 1) : y);
+    return (y * kWidth) + x;
+}
+
+void EventGrid::addEvent(bool bNorth, int cell)
+{
+    assert((cell >= 0) && (cell < kWidth * kHeight));
+
+    uint32_t* pRow = m_RowTotals[bNorth ? 0 : 1][cell / kWidth];
+    for (int x = (cell % kWidth) + 1; x <= kWidth; ++x)
+    {
+        ++pRow[x];
+    }
+}
+
+void EventGrid::addMove(bool bNorth, int fromCell, int toCell)
+{
+    if (fromCell != toCell)
+    {
+        addEvent(bNorth, fromCell);
+        addEvent(bNorth, toCell);
+    }
+}
+
+uint64_t EventGrid::sumEvents(bool bNorth, int cell, float radius) const
+{
+    assert((cell >= 0) && (cell < kWidth * kHeight));
+
+    // Anything within radius of some point in our cell is within this many
+    // cells of it.  The King sees the whole arena (and then some).
+    int reach = (radius < (float)kHeight) ? (int)ceilf(radius) : kHeight;
+
+    int cellX = cell % kWidth;
+    int cellY = cell / kWidth;
+    int minX = (cellX - reach < 0) ? 0 : (cellX - reach);
+    int maxX = (cellX + reach >= kWidth) ? (kWidth - 1) : (cellX + reach);
+    int minY = (cellY - reach < 0) ? 0 : (cellY - reach);
+    int maxY = (cellY + reach >= kHeight) ? (kHeight - 1) : (cellY + reach);
+
+    uint64_t sum = 0;
+    const uint32_t (*pRows)[kWidth + 1] = m_RowTotals[bNorth ? 0 : 1];
+    for (int y = minY; y <= maxY; ++y)
+    {
+        sum += pRows[y][maxX + 1] - pRows[y][minX];
+    }
+
+    return sum;
+}
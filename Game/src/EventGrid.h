@@ -0,0 +1,64 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Constants.h"
+#include "Vec2.h"
+
+#include <stdint.h>
+
+// Counts the events that can change an entity's choice of target - a spawn, 
+// a death, or a mob moving from one cell to another - in each cell of a grid 
+// over the arena, separately for each side.  An entity that sums the counts 
+// around it when it picks a target can tell whether anything has happened 
+// nearby since, without looking at the entities themselves.
+//
+// The cells are one tile square.  Each row keeps running totals, so adding an
+// event costs one row's width and summing a box costs one step per row.
+class EventGrid
+{
+public:
+    static const int kWidth = GAME_GRID_WIDTH;
+    static const int kHeight = GAME_GRID_HEIGHT;
+
+    EventGrid();
+
+    void clear();
+
+    // Positions off the edge of the arena count as being in the nearest cell
+    static int getCell(const Vec2& pos);
+
+    void addEvent(bool bNorth, int cell);
+
+    // Adds an event to both cells, if they're different
+    void addMove(bool bNorth, int fromCell, int toCell);
+
+    // The total number of events on one side, over every cell that could hold
+    // something within radius of some point in the given cell.  The totals 
+    // only ever go up, so if this changes then something has happened.
+    uint64_t sumEvents(bool bNorth, int cell, float radius) const;
+
+private:
+    // m_RowTotals[side][y][x] is the number of events in cells 0 to x-1 of row y
+    uint32_t m_RowTotals[2][kHeight][kWidth + 1];
+};
@@ -0,0 +1,102 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "FrameCapture.h"
+
+#include "SDL_image.h"
+
+#include <stdio.h>
+
+FrameCapture::FrameCapture(const std::string& directory)
+    : m_Directory(directory)
+    , m_bStopping(false)
+    , m_NumWritten(0)
+    , m_NumDropped(0)
+    , m_Thread(&FrameCapture::encodeLoop, this)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bStopping = true;
+    }
+    m_Wake.notify_one();
+    m_Thread.join();
+
+    if (m_NumDropped > 0)
+    {
+        printf("Frame capture: %d frames written, %d dropped because the encoder fell behind.\n",
+            m_NumWritten, m_NumDropped);
+    }
+}
+
+void FrameCapture::submit(SDL_Surface* pFrame, uint64_t tick)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Pending.size() >= kMaxPendingFrames)
+        {
+            ++m_NumDropped;
+            SDL_FreeSurface(pFrame);
+            return;
+        }
+
+        PendingFrame frame = { pFrame, tick };
+        m_Pending.push_back(frame);
+    }
+    m_Wake.notify_one();
+}
+
+void FrameCapture::encodeLoop()
+{
+    char path[1024];
+
+    while (true)
+    {
+        PendingFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [this] { return m_bStopping || !m_Pending.empty(); });
+
+            // Finish off whatever is queued before stopping
+            if (m_Pending.empty())
+                return;
+
+            frame = m_Pending.front();
+            m_Pending.pop_front();
+        }
+
+        snprintf(path, sizeof(path), "%s/frame_%06llu.png", m_Directory.c_str(), (unsigned long long)frame.m_Tick);
+        if (IMG_SavePNG(frame.m_pSurface, path) != 0)
+        {
+            printf("Failed to write %s: %s\n", path, IMG_GetError());
+        }
+        else
+        {
+            ++m_NumWritten;
+        }
+
+        SDL_FreeSurface(frame.m_pSurface);
+    }
+}
@@ -0,0 +1,80 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "SDL.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+
+// Writes captured frames out as PNGs on a background thread, so that PNG
+// encoding (which is slow) never holds up the simulation.  Frames are named
+// after the tick they show: <dir>/frame_000123.png
+class FrameCapture
+{
+public:
+    explicit FrameCapture(const std::string& directory);
+
+    // Blocks until every frame submitted so far has been written.
+    ~FrameCapture();
+
+    // Takes ownership of pFrame, which must be a copy that nothing else will
+    // touch.  If the encoder has fallen too far behind the frame is dropped
+    // rather than making the caller wait.
+    void submit(SDL_Surface* pFrame, uint64_t tick);
+
+    int getNumWritten() const { return m_NumWritten; }
+    int getNumDropped() const { return m_NumDropped; }
+
+private:
+    struct PendingFrame
+    {
+        SDL_Surface* m_pSurface;
+        uint64_t m_Tick;
+    };
+
+    void encodeLoop();
+
+    static const size_t kMaxPendingFrames = 32;
+
+    std::string m_Directory;
+
+    std::deque<PendingFrame> m_Pending;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    bool m_bStopping;
+
+    int m_NumWritten;       // only touched by the encoder thread
+    int m_NumDropped;       // only touched by submit()
+
+    std::thread m_Thread;   // declared last, so it starts after everything else is set up
+
+private:
+    // DELIBERATELY UNDEFINED
+    FrameCapture(const FrameCapture& rhs);
+    FrameCapture& operator=(const FrameCapture& rhs);
+};
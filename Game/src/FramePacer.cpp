@@ -0,0 +1,82 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "FramePacer.h"
+
+#include <thread>
+
+namespace
+{
+    // How far ahead of a deadline we stop trusting the OS to wake us on time
+    const std::chrono::microseconds kSpinMargin(1500);
+}
+
+FramePacer::FramePacer(float intervalSec)
+{
+    setInterval(intervalSec);
+    reset();
+}
+
+void FramePacer::setInterval(float intervalSec)
+{
+    m_Interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(intervalSec));
+}
+
+float FramePacer::getInterval() const
+{
+    return std::chrono::duration<float>(m_Interval).count();
+}
+
+void FramePacer::reset()
+{
+    m_LastFrame = Clock::now();
+    m_NextDeadline = m_LastFrame + m_Interval;
+}
+
+float FramePacer::waitForNextFrame()
+{
+    sleepUntil(m_NextDeadline);
+
+    Clock::time_point now = Clock::now();
+    float elapsedSec = std::chrono::duration<float>(now - m_LastFrame).count();
+    m_LastFrame = now;
+
+    // Measured from when we actually woke, so that the time between frames
+    // is never less than the interval (the simulation relies on that).
+    m_NextDeadline = now + m_Interval;
+
+    return elapsedSec;
+}
+
+void FramePacer::sleepUntil(Clock::time_point deadline)
+{
+    Clock::time_point now = Clock::now();
+    if (deadline - now > kSpinMargin)
+    {
+        std::this_thread::sleep_until(deadline - kSpinMargin);
+    }
+
+    while (Clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
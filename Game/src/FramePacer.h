@@ -0,0 +1,57 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+
+// Paces a loop to a fixed interval without burning a core.  Each call to
+// waitForNextFrame() sleeps until at least one interval has passed since the
+// previous call returned.  A loop that falls behind just runs late, it never
+// runs a burst of back-to-back frames to catch up.
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit FramePacer(float intervalSec);
+
+    void setInterval(float intervalSec);
+    float getInterval() const;
+
+    // Starts a new schedule, with the first deadline one interval from now.
+    void reset();
+
+    // Sleeps until the next deadline, then returns the time in seconds since
+    // the previous call returned.
+    float waitForNextFrame();
+
+    // Sleeps until the given time.  The OS sleep is coarse (often a millisecond
+    // or more), so we sleep until just short of the deadline and then yield
+    // for the rest.
+    static void sleepUntil(Clock::time_point deadline);
+
+private:
+    Clock::duration m_Interval;
+    Clock::time_point m_NextDeadline;
+    Clock::time_point m_LastFrame;
+};
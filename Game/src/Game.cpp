@@ -22,18 +22,34 @@
 
 #include "Game.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include "AllocTracker.h"
 #include "Building.h"
 #include "Constants.h"
 #include "Controller_UI.h"
 #include "Controller_AI_KevinDill.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
 #include "Mob.h"
 #include "Player.h"
+#include "Profiler.h"
+#include "RenderSnapshot.h"
+#include "SimStats.h"
 
 Game* Singleton<Game>::s_Obj = NULL;
 
+// How many entities each job in the decide phase gets.  Small enough to give
+// the threads something to steal, big enough that the queueing is noise.
+static const size_t kDecideGrainSize = 16;
+
 Game::Game()
-    : gameOverState(0) // No winner at start of game
+    : m_TickCount(0)
+    , m_SimTime(0.0)
+    , m_TickStartTime(0.0)
+    , m_Timers(TICK_MIN)
+    , gameOverState(0) // No winner at start of game
 {
     // FinalProject: This is where you specify which controllers to use - for 
     // instance, if you make two instances of your AI then it will play 
@@ -53,8 +69,186 @@ Game::~Game()
 
 void Game::tick(float deltaTSec)
 {
+    PROFILE_SCOPE("Game::tick");
+    ScopedSimTimer timer(SimStats::Tick);
+
+    SimStats& simStats = SimStats::get();
+    uint64_t queriesBefore = simStats.getCount(SimStats::SpatialQueries);
+    uint64_t pairsBefore = simStats.getCount(SimStats::CollisionPairs);
+    uint64_t allocationsBefore = AllocTracker::getNumSimAllocations();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Last tick's scratch data is all dead by now
+    FrameArena::getThreadArena().reset();
+
+    m_TickStartTime = m_SimTime;
+    m_SimTime += deltaTSec;
+    fireTimers();
+
+    // Everyone decides in parallel, then each player applies its decisions
+    decide();
+    m_Projectiles.update(deltaTSec, m_DamageBuffer);
     m_pNorthPlayer->tick(deltaTSec);
     m_pSouthPlayer->tick(deltaTSec);
+    m_AreaEffects.update(deltaTSec, m_DamageBuffer);
+    resolveDamage();
+    ++m_TickCount;
+    m_TickStartTime = m_SimTime;
+
+    m_LastTickStats.m_TickMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_LastTickStats.m_ControllerMs[0] = m_pNorthPlayer->getLastControllerMs();
+    m_LastTickStats.m_ControllerMs[1] = m_pSouthPlayer->getLastControllerMs();
+    m_LastTickStats.m_SpatialQueries = simStats.getCount(SimStats::SpatialQueries) - queriesBefore;
+    m_LastTickStats.m_CollisionPairs = simStats.getCount(SimStats::CollisionPairs) - pairsBefore;
+    m_LastTickStats.m_Allocations = AllocTracker::isCompiledIn()
+        ? (int64_t)(AllocTracker::getNumSimAllocations() - allocationsBefore)
+        : -1;
+    m_LastTickStats.m_FallbackLevel = m_TickBudget.getLevel();
+
+    // Any fallbacks this turns on (or off) start with the next tick
+    m_TickBudget.endTick(m_LastTickStats.m_TickMs);
+}
+
+int Game::skipQuietTicks(float deltaTSec, int maxTicks)
+{
+    PROFILE_SCOPE("Game::skipQuietTicks");
+
+    // Towers only ever have mobs to shoot at, so with no mobs (and no shots
+    // still on their way to the last of them, or spells still running down)
+    // there's nothing for the entities to do.
+    if (!m_pNorthPlayer->getMobs().empty() || !m_pSouthPlayer->getMobs().empty() ||
+        !m_Projectiles.empty() || !m_AreaEffects.empty())
+        return 0;
+
+    int numTicks = std::min(maxTicks, std::min(m_pNorthPlayer->getIdleTicks(), m_pSouthPlayer->getIdleTicks()));
+    if (numTicks <= 0)
+        return 0;
+
+    // Adding the ticks up one at a time keeps the clock exactly where ticking
+    // would have left it.  The only timers that can come due are the towers' 
+    // attack cooldowns, which don't care how late they're told.
+    for (int i = 0; i < numTicks; ++i)
+    {
+        m_SimTime += deltaTSec;
+    }
+    fireTimers();
+
+    m_pNorthPlayer->skipTicks(numTicks, deltaTSec);
+    m_pSouthPlayer->skipTicks(numTicks, deltaTSec);
+
+    m_TickCount += numTicks;
+    m_TickStartTime = m_SimTime;
+    return numTicks;
+}
+
+void Game::fireTimers()
+{
+    PROFILE_SCOPE("Game::fireTimers");
+
+    m_FiredTimers.clear();
+    m_Timers.advance(m_SimTime, m_FiredTimers);
+
+    for (const TimerWheel::Timer& timer : m_FiredTimers)
+    {
+        // Timers aren't cancelled when their entity dies; they just find
+        // the handle has gone stale.
+        Entity* pEntity = m_Registry.get(timer.m_Entity);
+        if (pEntity && !pEntity->isDead())
+        {
+            pEntity->onTimer(timer.m_Type, timer.m_Data);
+        }
+    }
+}
+
+void Game::decide()
+{
+    PROFILE_SCOPE("Game::decide");
+    ScopedSimTimer timer(SimStats::Decide);
+
+    // The packed positions hold exactly the live entities, so they double as 
+    // the list of who needs to decide.  Asking for them here also means that
+    // they're rebuilt now, rather than by the first job to look (which 
+    // wouldn't be thread safe).
+    FrameVector<Entity*> entities;
+    for (bool bNorth : { true, false })
+    {
+        const PackedPositions& buildings = getPlayer(bNorth).getPackedBuildings();
+        const PackedPositions& mobs = getPlayer(bNorth).getPackedMobs();
+        entities.insert(entities.end(), buildings.m_Entities.begin(), buildings.m_Entities.end());
+        entities.insert(entities.end(), mobs.m_Entities.begin(), mobs.m_Entities.end());
+    }
+
+    JobSystem::get().parallelFor(entities.size(), kDecideGrainSize,
+        [&entities](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                entities[i]->decide();
+            }
+        });
+}
+
+void Game::resolveDamage()
+{
+    PROFILE_SCOPE("Game::resolveDamage");
+
+    m_DamageBuffer.resolve(m_Registry);
+    m_pNorthPlayer->freeDeadMobs();
+    m_pSouthPlayer->freeDeadMobs();
+}
+
+void Game::buildSnapshot(RenderSnapshot& snapshot)
+{
+    PROFILE_SCOPE("Game::buildSnapshot");
+
+    snapshot.clear();
+    snapshot.m_Tick = m_TickCount;
+
+    for (bool bNorth : { true, false })
+    {
+        Player& player = getPlayer(bNorth);
+
+        for (const Entity* pBuilding : player.getBuildings())
+        {
+            addToSnapshot(pBuilding, snapshot.m_Buildings);
+        }
+
+        for (const Entity* pMob : player.getMobs())
+        {
+            // Mobs killed by the other player this tick haven't been freed yet
+            if (!pMob->isDead())
+            {
+                addToSnapshot(pMob, snapshot.m_Mobs);
+            }
+        }
+    }
+
+    m_Projectiles.addToSnapshot(snapshot);
+    m_AreaEffects.addToSnapshot(snapshot);
+
+    snapshot.m_NorthElixir = m_pNorthPlayer->getElixir();
+    snapshot.m_SouthElixir = m_pSouthPlayer->getElixir();
+    snapshot.m_GameOverState = checkGameOver();
+    snapshot.m_Stats = m_LastTickStats;
+}
+
+void Game::addToSnapshot(const Entity* pEntity, std::vector<RenderEntity>& entities)
+{
+    const iEntityStats& stats = pEntity->getStats();
+
+    RenderEntity e;
+    e.m_Pos = pEntity->getPosition();
+    e.m_Size = stats.getSize();
+    e.m_DisplayLetter = stats.getDisplayLetter();
+    e.m_Health = pEntity->getHealth();
+    e.m_MaxHealth = stats.getMaxHealth();
+    e.m_bNorth = pEntity->isNorth();
+    e.m_bDead = pEntity->isDead();
+    e.m_bHidden = pEntity->isHidden();
+    // NOTE: Buildings are never invisible, which keeps them away from
+    // getMobType() (it asserts for them).
+    e.m_bInvisible = pEntity->isInvisible() && (stats.getMobType() == iEntityStats::Rogue);
+    entities.push_back(e);
 }
 
 int Game::checkGameOver() {
@@ -79,10 +273,42 @@ int Game::checkGameOver() {
     return gameOverState;
 }
 
+void Game::startMatch(iController* pNorthControl, iController* pSouthControl)
+{
+    // Clear the registry first, since it touches the entities it removes
+    m_Registry.clear();
+
+    delete m_pNorthPlayer;
+    delete m_pSouthPlayer;
+
+    m_DamageBuffer.clear();
+    m_Projectiles.clear();
+    m_AreaEffects.clear();
+    m_EventGrid.clear();
+    m_Timers.clear();
+    m_TickCount = 0;
+    m_SimTime = 0.0;
+    m_TickStartTime = 0.0;
+    m_LastTickStats = SimTickStats();
+    gameOverState = 0;
+
+    buildPlayers(pNorthControl, pSouthControl);
+}
+
 void Game::buildPlayers(iController* pNorthControl, iController* pSouthControl)
 {
     m_pNorthPlayer = new Player(pNorthControl, true);
     m_pSouthPlayer = new Player(pSouthControl, false);
+
+    // The towers only move when they fall, so bake them into the field now
+    m_Obstacles.clear();
+    for (int i = 0; i < 2; ++i)
+    {
+        for (const Entity* pBuilding : getBuildings(i == 0))
+        {
+            m_Obstacles.addTower(pBuilding->getPosition(), pBuilding->getStats().getSize());
+        }
+    }
 }
 
 void Game::buildWaypoints()
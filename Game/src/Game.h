@@ -25,12 +25,23 @@
 #include "Singleton.h"
 #include "Vec2.h"
 #include <vector>
+#include "AreaEffects.h"
+#include "DamageBuffer.h"
+#include "EntityRegistry.h"
+#include "EventGrid.h"
+#include "ObstacleField.h"
 #include "Player.h"
+#include "ProjectilePool.h"
+#include "SimStats.h"
+#include "TickBudget.h"
+#include "TimerWheel.h"
 
 class Building;
 class iController;
 class Mob;
 class Player;
+struct RenderEntity;
+struct RenderSnapshot;
 
 class Game : public Singleton<Game>
 {
@@ -40,32 +51,119 @@ public:
 
     void tick(float deltaTSec);
 
+    // For headless runs.  While the board is empty, and neither controller
+    // will act, ticking only changes the clock and the elixir - so this jumps
+    // straight over up to maxTicks such ticks (of deltaTSec each), with the 
+    // same results as ticking through them.  Returns how many it skipped.
+    int skipQuietTicks(float deltaTSec, int maxTicks);
+
+    // Throws away the current match (players, controllers and all entities)
+    // and starts a fresh one.  We take ownership of the controllers, and either
+    // may be NULL.
+    void startMatch(iController* pNorthControl, iController* pSouthControl);
+
+    // The number of ticks that have been run so far
+    uint64_t getTickCount() const { return m_TickCount; }
+
+    // Simulation time, in seconds since the match started.  During a tick 
+    // it's the time at the end of the tick, and getTickStartTime() is the time
+    // at the start of it.  Between ticks, they're the same.
+    double getSimTime() const { return m_SimTime; }
+    double getTickStartTime() const { return m_TickStartTime; }
+
+    // Calls pEntity->onTimer(type, data) at the start of the first tick that
+    // ends at or after dueTime, if the entity is still alive by then.
+    // NOTE: Not thread safe, so don't call it from Entity::decide().
+    void scheduleTimer(double dueTime, EntityHandle entity, int type, uint32_t data = 0) {
+        m_Timers.schedule(dueTime, entity, type, data);
+    }
+
+    // Off unless the game loop sets a budget.  See TickBudget.
+    TickBudget& getTickBudget() { return m_TickBudget; }
+    const TickBudget& getTickBudget() const { return m_TickBudget; }
+
+    // Timings and counts from the most recent tick
+    const SimTickStats& getLastTickStats() const { return m_LastTickStats; }
+
+    // Copies out everything the renderer needs, so that it never has to touch
+    // live entities (which the simulation may be updating on another thread).
+    void buildSnapshot(RenderSnapshot& snapshot);
+
     Player& getPlayer(bool bNorth) { return bNorth ? *m_pNorthPlayer : *m_pSouthPlayer; }
 
+    // Attacks are recorded here and resolved at the end of the tick
+    DamageBuffer& getDamageBuffer() { return m_DamageBuffer; }
+
+    // Ranged attacks in flight, which land in the damage buffer on arrival
+    ProjectilePool& getProjectiles() { return m_Projectiles; }
+
+    // Spells that have been cast, which act at the end of the apply phase
+    AreaEffects& getAreaEffects() { return m_AreaEffects; }
+
+    // Spawns, deaths and moves between cells, for Entity::pickTarget()
+    EventGrid& getEventGrid() { return m_EventGrid; }
+    const EventGrid& getEventGrid() const { return m_EventGrid; }
+
+    // The arena edges, the river and the standing towers, for mob movement
+    ObstacleField& getObstacleField() { return m_Obstacles; }
+    const ObstacleField& getObstacleField() const { return m_Obstacles; }
+
+    EntityRegistry& getRegistry() { return m_Registry; }
+    const EntityRegistry& getRegistry() const { return m_Registry; }
+
     const std::vector<Vec2>& getWaypoints() const { return m_Waypoints; }
 
     int checkGameOver();
 
-    const std::vector<Entity*> getMobs(bool bNorth) {
+    const std::vector<Entity*>& getMobs(bool bNorth) {
         return bNorth ? m_pNorthPlayer->getMobs() : m_pSouthPlayer->getMobs();
     }
 
-    const std::vector<Entity*> getBuildings(bool bNorth) {
+    const std::vector<Entity*>& getBuildings(bool bNorth) {
         return bNorth ? m_pNorthPlayer->getBuildings() : m_pSouthPlayer->getBuildings();
     }
 
 private:
+    // Lets the entities whose timers are due this tick know
+    void fireTimers();
+
+    // The parallel sense/decide phase at the start of each tick
+    void decide();
+
+    // Applies the tick's damage, then frees whatever died
+    void resolveDamage();
+
     void buildPlayers(iController* pNorthControl, iController* pSouthControl);
 
     void buildWaypoints();
     void addFourWaypoints(Vec2 pt);
 
+    static void addToSnapshot(const Entity* pEntity, std::vector<RenderEntity>& entities);
+
 private:
+    // Declared before the players, since they register their entities with it
+    EntityRegistry m_Registry;
+
     Player* m_pNorthPlayer;
     Player* m_pSouthPlayer;
 
     std::vector<Vec2> m_Waypoints;
 
+    DamageBuffer m_DamageBuffer;
+    ProjectilePool m_Projectiles;
+    AreaEffects m_AreaEffects;
+    EventGrid m_EventGrid;
+    ObstacleField m_Obstacles;
+
+    uint64_t m_TickCount;
+    double m_SimTime;
+    double m_TickStartTime;
+
+    TimerWheel m_Timers;
+    std::vector<TimerWheel::Timer> m_FiredTimers;       // kept around so that firing doesn't allocate
+    SimTickStats m_LastTickStats;
+    TickBudget m_TickBudget;
+
     // Negative => South won, Positive => North won, 0 => no winner yet
     int gameOverState; 
 };
@@ -1,34 +1,68 @@
 #include "Graphics.h"
 
 #include "Constants.h"
+#include "FrameCapture.h"
+#include "Profiler.h"
 #include <algorithm>
 
 Graphics* Singleton<Graphics>::s_Obj = NULL;
-
-Graphics::Graphics() {
-	gWindow = SDL_CreateWindow("Crash Loyal", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH_PIXELS, SCREEN_HEIGHT_PIXELS, SDL_WINDOW_SHOWN);
-	if (gWindow == NULL) {
-		gRenderer = NULL;
-		printf("Window could not be created! SDL Error: %s\n", SDL_GetError());
+bool Graphics::s_bOffscreen = false;
+
+Graphics::Graphics()
+    : m_CurrentBatch(0)
+    , m_pStaticLayer(NULL)
+    , m_bStaticLayerSupported(false)
+    , m_bVSync(false)
+    , m_pTargetSurface(NULL)
+    , m_pCapture(NULL)
+    , m_CaptureEveryNTicks(0)
+    , m_FrameTick(0)
+    , m_pGlyphSurface(NULL)
+    , m_pGlyphTexture(NULL)
+    , m_GlyphHeight(0)
+{
+	if (s_bOffscreen) {
+		// No window - the software renderer draws straight into a surface that
+		// we own, which works on machines that have no display at all.
+		gWindow = NULL;
+		m_pTargetSurface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH_PIXELS, SCREEN_HEIGHT_PIXELS, 32, SDL_PIXELFORMAT_RGBA32);
+		if (m_pTargetSurface == NULL) {
+			gRenderer = NULL;
+			printf("Offscreen surface could not be created! SDL Error: %s\n", SDL_GetError());
+		}
+		else {
+			gRenderer = SDL_CreateSoftwareRenderer(m_pTargetSurface);
+			if (gRenderer == NULL) {
+				printf("Software renderer could not be created! SDL Error: %s\n", SDL_GetError());
+			}
+		}
 	}
 	else {
-		//Create renderer for window
-		gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED);
-		if (gRenderer == NULL) {
-			printf("Renderer could not be created! SDL Error: %s\n", SDL_GetError());
+		gWindow = SDL_CreateWindow("Crash Loyal", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH_PIXELS, SCREEN_HEIGHT_PIXELS, SDL_WINDOW_SHOWN);
+		if (gWindow == NULL) {
+			gRenderer = NULL;
+			printf("Window could not be created! SDL Error: %s\n", SDL_GetError());
 		}
 		else {
-			//Initialize renderer color
-			SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
-
-			//Initialize PNG loading
-			int imgFlags = IMG_INIT_PNG;
-			if (!(IMG_Init(imgFlags) & imgFlags)) {
-				printf("SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError());
+			//Create renderer for window
+			gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+			if (gRenderer == NULL) {
+				printf("Renderer could not be created! SDL Error: %s\n", SDL_GetError());
 			}
 		}
 	}
 
+	if (gRenderer) {
+		//Initialize renderer color
+		SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+
+		//Initialize PNG loading
+		int imgFlags = IMG_INIT_PNG;
+		if (!(IMG_Init(imgFlags) & imgFlags)) {
+			printf("SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError());
+		}
+	}
+
     // init the text libraries
     if (TTF_Init() < 0) {
         printf("Text library TTF could not be Initialized correctly.\n");
@@ -37,57 +71,292 @@ Graphics::Graphics() {
     // Load in the font 
     sans = TTF_OpenFont("fonts/abelregular.ttf", 36);
     if (!sans) { printf("TTF_OpenFont: %s\n", TTF_GetError()); }
+
+    buildGlyphAtlas();
+
+    // Not every driver honors the vsync request, so check what we actually got
+    SDL_RendererInfo info;
+    if (gRenderer && (SDL_GetRendererInfo(gRenderer, &info) == 0)) {
+        m_bVSync = (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+    }
+
+    m_bStaticLayerSupported = gRenderer && (SDL_RenderTargetSupported(gRenderer) == SDL_TRUE);
+    if (!m_bStaticLayerSupported) {
+        printf("Render targets not supported, the arena will be redrawn every frame.\n");
+    }
 }
 
 Graphics::~Graphics() {
+    invalidateStaticLayer();
+    clearTextCache();
+    SDL_DestroyTexture(m_pGlyphTexture);
+    SDL_FreeSurface(m_pGlyphSurface);
+    if (sans) { TTF_CloseFont(sans); }
+
+    // Waits for any frames that are still being written
+    delete m_pCapture;
+
 	SDL_DestroyRenderer(gRenderer);
-	SDL_DestroyWindow(gWindow);
+	if (gWindow) { SDL_DestroyWindow(gWindow); }
+	if (m_pTargetSurface) { SDL_FreeSurface(m_pTargetSurface); }
+}
+
+void Graphics::setOffscreen(bool bOffscreen) {
+    // Has to be decided before the renderer is created
+    assert(!exists());
+    s_bOffscreen = bOffscreen;
+}
+
+void Graphics::setCapture(const std::string& directory, int everyNTicks, const std::vector<uint64_t>& ticks) {
+    if (!s_bOffscreen) {
+        printf("Frame capture is only supported when rendering offscreen.\n");
+        return;
+    }
+
+    delete m_pCapture;
+    m_pCapture = new FrameCapture(directory);
+    m_CaptureEveryNTicks = everyNTicks;
+    m_CaptureTicks.clear();
+    m_CaptureTicks.insert(ticks.begin(), ticks.end());
+}
+
+void Graphics::addCaptureTick(uint64_t tick) {
+    m_CaptureTicks.insert(tick);
+}
+
+void Graphics::endCapture() {
+    delete m_pCapture;
+    m_pCapture = NULL;
+}
+
+bool Graphics::wantsCapture(uint64_t tick) const {
+    if (!m_pCapture) {
+        return false;
+    }
+
+    return ((m_CaptureEveryNTicks > 0) && ((tick % m_CaptureEveryNTicks) == 0)) ||
+        (m_CaptureTicks.find(tick) != m_CaptureTicks.end());
+}
+
+void Graphics::captureFrame(uint64_t tick) {
+    // The encoder gets its own copy, so we can carry on drawing into the target
+    SDL_Surface* pCopy = SDL_DuplicateSurface(m_pTargetSurface);
+    if (!pCopy) {
+        printf("Failed to copy frame %llu: %s\n", (unsigned long long)tick, SDL_GetError());
+        return;
+    }
+
+    m_pCapture->submit(pCopy, tick);
+}
+
+void Graphics::buildGlyphAtlas() {
+    if (!sans || !gRenderer) { return; }
+
+    // Render every glyph in white, so that color can be applied with a color mod
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface* glyphs[kNumGlyphs];
+
+    const int maxRowWidth = 1024;
+    int x = 0;
+    int y = 0;
+    m_GlyphHeight = TTF_FontHeight(sans);
+
+    for (int i = 0; i < kNumGlyphs; ++i) {
+        glyphs[i] = TTF_RenderGlyph_Blended(sans, (Uint16)(kFirstGlyph + i), white);
+        int w = glyphs[i] ? glyphs[i]->w : 0;
+
+        if (x + w > maxRowWidth) {
+            x = 0;
+            y += m_GlyphHeight;
+        }
+
+        m_GlyphRects[i] = { x, y, w, m_GlyphHeight };
+        x += w;
+    }
+
+    m_pGlyphSurface = SDL_CreateRGBSurfaceWithFormat(0, maxRowWidth, y + m_GlyphHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!m_pGlyphSurface) { printf("Glyph atlas could not be created! SDL Error: %s\n", SDL_GetError()); }
+
+    for (int i = 0; i < kNumGlyphs; ++i) {
+        if (glyphs[i] && m_pGlyphSurface) {
+            // Copy the glyph as-is (alpha included) rather than blending it
+            SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphs[i], NULL, m_pGlyphSurface, &m_GlyphRects[i]);
+        }
+        SDL_FreeSurface(glyphs[i]);
+    }
+
+    if (m_pGlyphSurface) {
+        SDL_SetSurfaceBlendMode(m_pGlyphSurface, SDL_BLENDMODE_NONE);
+        m_pGlyphTexture = SDL_CreateTextureFromSurface(gRenderer, m_pGlyphSurface);
+        SDL_SetTextureBlendMode(m_pGlyphTexture, SDL_BLENDMODE_BLEND);
+    }
+}
+
+SDL_Texture* Graphics::getTextTexture(const char* textToDraw, SDL_Color color) {
+    std::string key(textToDraw);
+    key.push_back('\0');
+    key.push_back((char)color.r);
+    key.push_back((char)color.g);
+    key.push_back((char)color.b);
+    key.push_back((char)color.a);
+
+    std::unordered_map<std::string, SDL_Texture*>::iterator it = m_TextCache.find(key);
+    if (it != m_TextCache.end()) {
+        return it->second;
+    }
+
+    if (!m_pGlyphSurface) { return NULL; }
+
+    // The cache only ever sees a small set of strings in practice (letters,
+    // elixir values, messages), so if it fills up just start over.
+    if (m_TextCache.size() >= kMaxCachedStrings) {
+        clearTextCache();
+    }
+
+    // Lay the string out from the atlas
+    int width = 0;
+    for (const char* c = textToDraw; *c; ++c) {
+        if ((*c >= kFirstGlyph) && (*c <= kLastGlyph)) {
+            width += m_GlyphRects[*c - kFirstGlyph].w;
+        }
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, std::max(width, 1), m_GlyphHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) { printf("Text surface could not be created! SDL Error: %s\n", SDL_GetError()); return NULL; }
+
+    SDL_Rect dest = { 0, 0, 0, m_GlyphHeight };
+    for (const char* c = textToDraw; *c; ++c) {
+        if ((*c >= kFirstGlyph) && (*c <= kLastGlyph)) {
+            SDL_Rect src = m_GlyphRects[*c - kFirstGlyph];
+            dest.w = src.w;
+            SDL_BlitSurface(m_pGlyphSurface, &src, surface, &dest);
+            dest.x += src.w;
+        }
+    }
+
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(gRenderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) { printf("Text texture could not be created! SDL Error: %s\n", SDL_GetError()); return NULL; }
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+
+    m_TextCache[key] = texture;
+    return texture;
+}
+
+void Graphics::clearTextCache() {
+    for (std::unordered_map<std::string, SDL_Texture*>::value_type& entry : m_TextCache) {
+        SDL_DestroyTexture(entry.second);
+    }
+    m_TextCache.clear();
 }
 
 void Graphics::render() {
-    SDL_RenderPresent(gRenderer);
+    flushBatches();
+
+    {
+        // With vsync on, this is where we wait for the display
+        PROFILE_SCOPE("Graphics::present");
+        SDL_RenderPresent(gRenderer);
+    }
+
+    // The software renderer queues up draw calls, so we can only be sure the 
+    // surface is up to date after presenting.
+    if (wantsCapture(m_FrameTick)) {
+        captureFrame(m_FrameTick);
+    }
+}
+
+bool Graphics::isWindowVisible() const {
+    if (!gWindow) {
+        return false;
+    }
+
+    Uint32 flags = SDL_GetWindowFlags(gWindow);
+    return !(flags & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED));
 }
 
 void Graphics::resetFrame() {
+    PROFILE_SCOPE("Graphics::resetFrame");
+
+    if (!m_bStaticLayerSupported) {
+        drawBG();
+        drawUI();
+        return;
+    }
+
+    if (!m_pStaticLayer) {
+        buildStaticLayer();
+    }
+
+    SDL_RenderCopy(gRenderer, m_pStaticLayer, NULL, NULL);
+}
+
+void Graphics::invalidateStaticLayer() {
+    if (m_pStaticLayer) {
+        SDL_DestroyTexture(m_pStaticLayer);
+        m_pStaticLayer = NULL;
+    }
+}
+
+void Graphics::buildStaticLayer() {
+    m_pStaticLayer = SDL_CreateTexture(gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+        SCREEN_WIDTH_PIXELS, SCREEN_HEIGHT_PIXELS);
+    if (!m_pStaticLayer) {
+        printf("Static layer could not be created! SDL Error: %s\n", SDL_GetError());
+        m_bStaticLayerSupported = false;
+        drawBG();
+        drawUI();
+        return;
+    }
+
+    // The layer is the bottom of the frame, so it replaces whatever is there
+    SDL_SetTextureBlendMode(m_pStaticLayer, SDL_BLENDMODE_NONE);
+
+    SDL_SetRenderTarget(gRenderer, m_pStaticLayer);
     drawBG();
     drawUI();
+    SDL_SetRenderTarget(gRenderer, NULL);
 }
 
-void Graphics::drawMob(Entity* m)
+void Graphics::drawMob(const RenderEntity& m)
 {
     // Project 2: Comment this out if you want Rogues to be visible for debugging
-    if (m->getStats().getName() == "Rogue" && m->isInvisible()) return;
+    if (m.m_bInvisible) return;
 
 	int alpha = healthToAlpha(m);
 
-    if (m->isNorth())
+    if (m.m_bNorth)
     {
-        if (!m->isHidden())
+        if (!m.m_bHidden)
         {
-            SDL_SetRenderDrawColor(gRenderer, 0xFF, 0x00, 0x00, alpha);
+            setBatchColor(0xFF, 0x00, 0x00, alpha);
         }
         else
         {
-            SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xA0, 0xA0, alpha);
+            setBatchColor(0xFF, 0xA0, 0xA0, alpha);
         }
     }
     else
     {
-        if (!m->isHidden())
+        if (!m.m_bHidden)
         {
-            SDL_SetRenderDrawColor(gRenderer, 0x00, 0x00, 0xFF, alpha);
+            setBatchColor(0x00, 0x00, 0xFF, alpha);
         }
         else
         {
-            SDL_SetRenderDrawColor(gRenderer, 0xA0, 0xA0, 0xFF, alpha);
+            setBatchColor(0xA0, 0xA0, 0xFF, alpha);
         }
     }
 
-	float centerX = m->getPosition().x * PIXELS_PER_METER;
-	float centerY = m->getPosition().y * PIXELS_PER_METER;
-	float squareSize = m->getStats().getSize() * PIXELS_PER_METER;
+	float centerX = m.m_Pos.x * PIXELS_PER_METER;
+	float centerY = m.m_Pos.y * PIXELS_PER_METER;
+	float squareSize = m.m_Size * PIXELS_PER_METER;
 
-	drawSquare(centerX, centerY, squareSize);
+	queueSquare(centerX, centerY, squareSize);
 
 	SDL_Rect stringRect = {
 		(int)(centerX - (squareSize / 2.f)),
@@ -96,63 +365,204 @@ void Graphics::drawMob(Entity* m)
 		(int)squareSize
 	};
 	SDL_Color stringColor = { 0, 0, 0, 255 };
-	drawText(m->getStats().getDisplayLetter(), stringRect, stringColor);
+	queueText(m.m_DisplayLetter, stringRect, stringColor);
+}
+
+void Graphics::drawMobs(const std::vector<RenderEntity>& mobs)
+{
+    PROFILE_SCOPE("Graphics::drawMobs");
+
+    for (const RenderEntity& m : mobs) {
+        if (!m.m_bDead) {
+            drawMob(m);
+        }
+    }
 }
 
+void Graphics::drawBuildings(const std::vector<RenderEntity>& buildings)
+{
+    PROFILE_SCOPE("Graphics::drawBuildings");
+
+    for (const RenderEntity& b : buildings) {
+        drawBuilding(b);
+    }
+}
+
+void Graphics::drawAreaEffects(const std::vector<RenderAreaEffect>& effects)
+{
+    PROFILE_SCOPE("Graphics::drawAreaEffects");
+
+    for (const RenderAreaEffect& e : effects) {
+        switch (e.m_Type) {
+            case iSpellStats::Fireball:
+                setBatchColor(0xFF, 0x60, 0x00, 0x60);
+                break;
+            case iSpellStats::Tornado:
+                setBatchColor(0x80, 0x80, 0x80, 0x60);
+                break;
+            default:
+                setBatchColor(0xC0, 0x00, 0xC0, 0x40);
+                break;
+        }
+
+        queueSquare(e.m_Pos.x * PIXELS_PER_METER, e.m_Pos.y * PIXELS_PER_METER, 2.f * e.m_Radius * PIXELS_PER_METER);
+    }
+}
+
+void Graphics::drawProjectiles(const std::vector<RenderProjectile>& projectiles)
+{
+    PROFILE_SCOPE("Graphics::drawProjectiles");
+
+    // One batch (and so one draw call) per side, however many are in flight
+    const float size = PROJECTILE_SIZE * PIXELS_PER_METER;
+    for (bool bNorth : { true, false }) {
+        if (bNorth) {
+            setBatchColor(0xFF, 0x80, 0x00, 0xFF);
+        } else {
+            setBatchColor(0x00, 0xC0, 0xFF, 0xFF);
+        }
+
+        for (const RenderProjectile& p : projectiles) {
+            if (p.m_bNorth == bNorth) {
+                queueSquare(p.m_Pos.x * PIXELS_PER_METER, p.m_Pos.y * PIXELS_PER_METER, size);
+            }
+        }
+    }
+}
+
+void Graphics::drawSnapshot(const RenderSnapshot& snapshot)
+{
+    PROFILE_SCOPE("Graphics::drawSnapshot");
+
+    m_FrameTick = snapshot.m_Tick;
+
+    // Buildings are flushed first so that units are drawn on top of them
+    drawBuildings(snapshot.m_Buildings);
+    flushBatches();
+
+    // Spells are faint, and go under the units they're affecting
+    drawAreaEffects(snapshot.m_AreaEffects);
+    flushBatches();
+
+    drawMobs(snapshot.m_Mobs);
+    flushBatches();
+
+    // Projectiles go on top of everything, since they're small
+    drawProjectiles(snapshot.m_Projectiles);
+    flushBatches();
+
+    drawElixir(snapshot.m_NorthElixir, snapshot.m_SouthElixir);
+
+    // If there is a winner, draw the message to the screen
+    drawWinScreen(snapshot.m_GameOverState);
+}
+
+int Graphics::healthToAlpha(const RenderEntity& e)
+{
+    float health = std::max(0.f, (float)e.m_Health);
+    float maxHealth = (float)e.m_MaxHealth;
+    return (int)(((health / maxHealth) * 200.f) + 55.f);
+}
+
+void Graphics::drawBuilding(const RenderEntity& b) {
+    int alpha = healthToAlpha(b);
+
+    if (b.m_bDead)
+        setBatchColor(0x00, 0x00, 0x00, 100);
+    else if (b.m_bNorth)
+        setBatchColor(0xFF, 0x00, 0x00, alpha);
+    else
+        setBatchColor(0x00, 0x00, 0xFF, alpha);
+
+    queueSquare(b.m_Pos.x * PIXELS_PER_METER,
+        b.m_Pos.y * PIXELS_PER_METER,
+        b.m_Size * PIXELS_PER_METER);
+}
+
+void Graphics::setBatchColor(Uint8 r, Uint8 g, Uint8 b, int a) {
+    // Health is shown through alpha, so every unit could otherwise end up in a
+    // batch of its own.  16 levels is plenty to see the difference.
+    Uint8 alpha = (Uint8)std::min(255, (a & ~0xF) | 0xF);
+
+    for (size_t i = 0; i < m_RectBatches.size(); ++i) {
+        const SDL_Color& c = m_RectBatches[i].m_Color;
+        if ((c.r == r) && (c.g == g) && (c.b == b) && (c.a == alpha)) {
+            m_CurrentBatch = i;
+            return;
+        }
+    }
+
+    RectBatch batch;
+    batch.m_Color = { r, g, b, alpha };
+    m_RectBatches.push_back(batch);
+    m_CurrentBatch = m_RectBatches.size() - 1;
+}
+
+void Graphics::queueSquare(float centerX, float centerY, float size) {
+    assert(m_CurrentBatch < m_RectBatches.size());
 
-void Graphics::drawSquare(float centerX, float centerY, float size) {
-    // Draws a square at the given pixel coorinate
     SDL_Rect rect = {
         (int)(centerX - (size / 2.f)),
         (int)(centerY - (size / 2.f)),
         (int)(size),
         (int)(size)
     };
-    SDL_RenderFillRect(gRenderer, &rect);
+    m_RectBatches[m_CurrentBatch].m_Rects.push_back(rect);
 }
 
-int Graphics::healthToAlpha(const Entity* e)
-{
-    float health = std::max(0.f, (float)e->getHealth());
-    float maxHealth = (float)e->getStats().getMaxHealth();
-    return (int)(((health / maxHealth) * 200.f) + 55.f);
+void Graphics::queueRect(int x, int y, int w, int h) {
+    assert(m_CurrentBatch < m_RectBatches.size());
+
+    SDL_Rect rect = { x, y, w, h };
+    m_RectBatches[m_CurrentBatch].m_Rects.push_back(rect);
 }
 
-void Graphics::drawBuilding(Entity* b) {
-    int alpha = healthToAlpha(b);
+void Graphics::queueText(const char* textToDraw, SDL_Rect messageRect, SDL_Color color) {
+    QueuedText text = { textToDraw, messageRect, color };
+    m_QueuedText.push_back(text);
+}
 
-    if (b->isDead())
-        SDL_SetRenderDrawColor(gRenderer, 0x00, 0x00, 0x00, 100);
-    else if (b->isNorth())
-        SDL_SetRenderDrawColor(gRenderer, 0xFF, 0x00, 0x00, alpha);
-    else
-        SDL_SetRenderDrawColor(gRenderer, 0x00, 0x00, 0xFF, alpha);
+void Graphics::flushBatches() {
+    PROFILE_SCOPE("Graphics::flushBatches");
+
+    for (RectBatch& batch : m_RectBatches) {
+        if (!batch.m_Rects.empty()) {
+            SDL_SetRenderDrawColor(gRenderer, batch.m_Color.r, batch.m_Color.g, batch.m_Color.b, batch.m_Color.a);
+            SDL_RenderFillRects(gRenderer, &batch.m_Rects[0], (int)batch.m_Rects.size());
+            batch.m_Rects.clear();
+        }
+    }
 
-    drawSquare(b->getPosition().x * PIXELS_PER_METER,
-        b->getPosition().y * PIXELS_PER_METER,
-        b->getStats().getSize() * PIXELS_PER_METER);
+    // Text goes on top of the squares
+    for (const QueuedText& text : m_QueuedText) {
+        drawText(text.m_Text, text.m_Rect, text.m_Color);
+    }
+    m_QueuedText.clear();
 }
 
 void Graphics::drawText(const char* textToDraw, SDL_Rect messageRect, SDL_Color color) {
     // Draws the given text in a box with the specified position and dimention
+    SDL_Texture* message = getTextTexture(textToDraw, color);
+    if (message) {
+        SDL_RenderCopy(gRenderer, message, NULL, &messageRect);
+    }
+}
+
+void Graphics::drawDynamicText(const char* textToDraw, int x, int y, int height, SDL_Color color) {
+    if (!m_pGlyphTexture || (m_GlyphHeight <= 0)) { return; }
 
-    SDL_Surface* surfaceMessage = TTF_RenderText_Solid(sans, textToDraw, color); // TODO Make this print something other than m
-    if (!surfaceMessage) { printf("TTF_OpenFont: %s\n", TTF_GetError()); }
-    SDL_Texture* message = SDL_CreateTextureFromSurface(gRenderer, surfaceMessage);
-    if (!message) { printf("Error 2\n"); }
-    //SDL_Rect messageRect = {
-    //    topLeftXPix,
-    //    topLeftYPix,
-    //    boxWidth,
-    //    boxHeight
-    //    //(int)(centerX - (squareSize / 2.f)),
-    //    //(int)(centerY - (squareSize / 2.f)),
-    //    //(int)squareSize,
-    //    //(int)squareSize
-    //};
-    SDL_RenderCopy(gRenderer, message, NULL, &messageRect);
-    SDL_FreeSurface(surfaceMessage);
-    SDL_DestroyTexture(message);
+    SDL_SetTextureColorMod(m_pGlyphTexture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(m_pGlyphTexture, color.a);
+
+    SDL_Rect dest = { x, y, 0, height };
+    for (const char* c = textToDraw; *c; ++c) {
+        if ((*c >= kFirstGlyph) && (*c <= kLastGlyph)) {
+            const SDL_Rect& src = m_GlyphRects[*c - kFirstGlyph];
+            dest.w = (src.w * height) / m_GlyphHeight;
+            SDL_RenderCopy(gRenderer, m_pGlyphTexture, &src, &dest);
+            dest.x += dest.w;
+        }
+    }
 }
 
 void Graphics::drawGrid() {
@@ -220,6 +630,8 @@ void Graphics::drawBG() {
 
 void Graphics::drawElixir(float northElixir, float southElixir)
 {
+    PROFILE_SCOPE("Graphics::drawElixir");
+
     int xBuffer = 10;
     int yBuffer = 100;
     int height = 20;
@@ -244,6 +656,8 @@ void Graphics::drawElixir(float northElixir, float southElixir)
 void Graphics::drawWinScreen(int winningSide) {
     if (winningSide == 0) { return; }
 
+    PROFILE_SCOPE("Graphics::drawWinScreen");
+
     const char* msg = (winningSide > 0) ? "Game Over. North Wins!" : "Game Over. South Wins!";
     int topY = SCREEN_HEIGHT_PIXELS / 5;
     int leftX = SCREEN_WIDTH_PIXELS / 15;
@@ -255,6 +669,112 @@ void Graphics::drawWinScreen(int winningSide) {
     drawText(msg, stringRect, color);
 }
 
+void Graphics::drawPerfOverlay(const PerfOverlay& overlay, const RenderSnapshot& snapshot) {
+    if (!overlay.isVisible()) { return; }
+
+    PROFILE_SCOPE("Graphics::drawPerfOverlay");
+
+    const int left = (GAME_GRID_WIDTH * PIXELS_PER_METER) + 10;
+    const int lineHeight = 18;
+    const SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+    const SDL_Color red = { 0xFF, 0x60, 0x60, 0xFF };
+    const SDL_Color blue = { 0x80, 0x80, 0xFF, 0xFF };
+
+    // Backdrop, so the text is readable over whatever the UI panel has on it
+    setBatchColor(0x00, 0x00, 0x00, 0xC0);
+    queueRect(left - 5, 5, (UI_WIDTH * PIXELS_PER_METER) - 10, 400);
+    flushBatches();
+
+    char msg[128];
+    int y = 10;
+
+    const PerfHistory& frames = overlay.getFrames();
+    snprintf(msg, sizeof(msg), "Frame %5.2f ms  avg %5.2f  p99 %5.2f",
+        frames.getCurrent(), frames.getAverage(), frames.getPercentile(0.99f));
+    drawDynamicText(msg, left, y, lineHeight, white);
+    y += lineHeight + 2;
+    y = drawPerfGraph(frames, FRAME_TIME * 1000.f, left, y) + 8;
+
+    const PerfHistory& ticks = overlay.getTicks();
+    snprintf(msg, sizeof(msg), "Tick  %5.2f ms  avg %5.2f  p99 %5.2f",
+        ticks.getCurrent(), ticks.getAverage(), ticks.getPercentile(0.99f));
+    drawDynamicText(msg, left, y, lineHeight, white);
+    y += lineHeight + 2;
+    y = drawPerfGraph(ticks, TICK_MIN * 1000.f, left, y) + 8;
+
+    int numNorth = 0;
+    int numSouth = 0;
+    for (const RenderEntity& m : snapshot.m_Mobs) {
+        if (m.m_bDead) { continue; }
+        if (m.m_bNorth) { ++numNorth; } else { ++numSouth; }
+    }
+
+    const SimTickStats& stats = snapshot.m_Stats;
+
+    snprintf(msg, sizeof(msg), "Units       %d", numNorth);
+    drawDynamicText(msg, left, y, lineHeight, red);
+    snprintf(msg, sizeof(msg), "%d", numSouth);
+    drawDynamicText(msg, left + 170, y, lineHeight, blue);
+    y += lineHeight;
+
+    snprintf(msg, sizeof(msg), "Controller  %.2f ms", stats.m_ControllerMs[0]);
+    drawDynamicText(msg, left, y, lineHeight, red);
+    snprintf(msg, sizeof(msg), "%.2f ms", stats.m_ControllerMs[1]);
+    drawDynamicText(msg, left + 170, y, lineHeight, blue);
+    y += lineHeight;
+
+    snprintf(msg, sizeof(msg), "Spatial queries/tick  %llu", (unsigned long long)stats.m_SpatialQueries);
+    drawDynamicText(msg, left, y, lineHeight, white);
+    y += lineHeight;
+
+    snprintf(msg, sizeof(msg), "Collision pairs/tick  %llu", (unsigned long long)stats.m_CollisionPairs);
+    drawDynamicText(msg, left, y, lineHeight, white);
+    y += lineHeight;
+
+    if (stats.m_Allocations >= 0) {
+        snprintf(msg, sizeof(msg), "Allocations/tick      %lld", (long long)stats.m_Allocations);
+    }
+    else {
+        snprintf(msg, sizeof(msg), "Allocations/tick      n/a");
+    }
+    drawDynamicText(msg, left, y, lineHeight, white);
+    y += lineHeight;
+
+    snprintf(msg, sizeof(msg), "Budget fallbacks      %d", stats.m_FallbackLevel);
+    drawDynamicText(msg, left, y, lineHeight, (stats.m_FallbackLevel > 0) ? red : white);
+}
+
+int Graphics::drawPerfGraph(const PerfHistory& history, float budgetMs, int x, int y) {
+    // One bar per sample, scaled so that the budget line sits halfway up the
+    // graph unless something is further over budget than that.
+    const int graphHeight = 60;
+    const int barWidth = 2;
+    float scale = std::max(budgetMs * 2.f, history.getMax());
+
+    setBatchColor(0x40, 0x40, 0x40, 0xFF);
+    queueRect(x, y, (int)PerfHistory::kNumSamples * barWidth, graphHeight);
+    flushBatches();
+
+    for (size_t i = 0; i < history.size(); ++i) {
+        float ms = history.getSample(i);
+        int barHeight = std::max(1, (int)((ms / scale) * graphHeight));
+        if (ms > budgetMs) {
+            setBatchColor(0xFF, 0x40, 0x40, 0xFF);
+        }
+        else {
+            setBatchColor(0x40, 0xFF, 0x40, 0xFF);
+        }
+        queueRect(x + ((int)i * barWidth), y + graphHeight - barHeight, barWidth, barHeight);
+    }
+
+    int budgetY = y + graphHeight - (int)((budgetMs / scale) * graphHeight);
+    setBatchColor(0xFF, 0xFF, 0x00, 0xFF);
+    queueRect(x, budgetY, (int)PerfHistory::kNumSamples * barWidth, 1);
+    flushBatches();
+
+    return y + graphHeight;
+}
+
 void Graphics::drawUI() {
     // Draws the rectangle to the right of the play area that contains the UI
 
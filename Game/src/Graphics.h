@@ -1,11 +1,20 @@
 #pragma once
 
-#include "Entity.h"
+#include "PerfOverlay.h"
+#include "RenderSnapshot.h"
 #include "SDL.h"
 #include "SDL_image.h"
 #include "SDL_ttf.h"
 #include "Singleton.h"
 
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FrameCapture;
+
 class Graphics : public Singleton<Graphics> {
 	/**
 	 * Houses the logic for drawing the game to the screen.
@@ -16,27 +25,140 @@ public:
 	Graphics();
 	virtual ~Graphics();  //SDL_DestroyRenderer(gRenderer);
 
-	void drawMob(Entity* m);
+	// Call before the first Graphics::get() to render with the software
+	// renderer into an offscreen surface instead of opening a window.
+	static void setOffscreen(bool bOffscreen);
+	static bool isOffscreen() { return s_bOffscreen; }
+
+	// Offscreen only: saves a PNG of every frame whose snapshot tick is a
+	// multiple of everyNTicks (0 to disable) or is listed in ticks.  The PNGs
+	// are encoded on a background thread.
+	void setCapture(const std::string& directory, int everyNTicks, const std::vector<uint64_t>& ticks);
+	void addCaptureTick(uint64_t tick);
+	bool wantsCapture(uint64_t tick) const;
+
+	// Waits for every captured frame to be written, then stops capturing.
+	void endCapture();
+
+	// Draws everything in the snapshot: buildings, units, elixir and the win
+	// screen.  Graphics only ever sees snapshots, never live entities.
+	void drawSnapshot(const RenderSnapshot& snapshot);
+
+	// Units and buildings are not drawn immediately.  Their squares are queued
+	// up, grouped by color, and submitted with one SDL_RenderFillRects call per
+	// color when flushBatches() is called (or when the frame is rendered).
+	void drawMob(const RenderEntity& m);
+	void drawBuilding(const RenderEntity& b);
+	void drawMobs(const std::vector<RenderEntity>& mobs);
+	void drawBuildings(const std::vector<RenderEntity>& buildings);
+	void drawAreaEffects(const std::vector<RenderAreaEffect>& effects);
+	void drawProjectiles(const std::vector<RenderProjectile>& projectiles);
+	void flushBatches();
+
+	// Draws the text stretched to fill messageRect.  The texture for each
+	// (text, color) pair is built once and then reused on later frames, so
+	// use this for strings that repeat (unit letters, labels, counters).
 	void drawText(const char* textToDraw, SDL_Rect messageRect, SDL_Color color);
-	void drawBuilding(Entity* b);
+
+	// Draws the text glyph by glyph straight out of the atlas, with its top left
+	// corner at (x, y).  Nothing is cached, so use this for strings that change
+	// every frame (timings, stats) rather than filling up the text cache.
+	void drawDynamicText(const char* textToDraw, int x, int y, int height, SDL_Color color);
 
 	void resetFrame();
 
+	// The arena and UI panel never change, so they are rendered once into a 
+	// texture and copied each frame.  Call this if the texture may have been
+	// lost (window resized, render targets reset) so it's rebuilt next frame.
+	void invalidateStaticLayer();
+
 	void drawElixir(float northElixir, float southElixir);
 	void drawWinScreen(int winningSide);
 
+	// Draws frame and tick timings, with graphs, plus the counts from the
+	// snapshot's tick over the UI panel.  Does nothing if the overlay is hidden.
+	void drawPerfOverlay(const PerfOverlay& overlay, const RenderSnapshot& snapshot);
+
 	void render();
 
+	// If true, render() blocks until the display's next refresh, so the 
+	// render loop is already paced and doesn't need to sleep on its own.
+	bool hasVSync() const { return m_bVSync; }
+
+	// False if the window is minimized or hidden, in which case there's no
+	// point in drawing anything.
+	bool isWindowVisible() const;
+
 private: 
 
-	void drawSquare(float centerX, float centerY, float size);
-	int healthToAlpha(const Entity* e);
+	int healthToAlpha(const RenderEntity& e);
+
+	void setBatchColor(Uint8 r, Uint8 g, Uint8 b, int a);
+	void queueSquare(float centerX, float centerY, float size);
+	void queueRect(int x, int y, int w, int h);
+	void queueText(const char* textToDraw, SDL_Rect messageRect, SDL_Color color);
 
 	void drawGrid();
 	void drawBG();
 	void drawUI();
+	int drawPerfGraph(const PerfHistory& history, float budgetMs, int x, int y);
+
+	void buildStaticLayer();
+
+	void captureFrame(uint64_t tick);
+
+	// The glyph atlas covers the printable ASCII characters.  It is rendered
+	// once from the font at startup; after that no text goes through SDL_ttf.
+	static const int kFirstGlyph = ' ';
+	static const int kLastGlyph = '~';
+	static const int kNumGlyphs = kLastGlyph - kFirstGlyph + 1;
+	static const size_t kMaxCachedStrings = 256;
+
+	void buildGlyphAtlas();
+	SDL_Texture* getTextTexture(const char* textToDraw, SDL_Color color);
+	void clearTextCache();
 
 	SDL_Renderer* gRenderer;
 	SDL_Window* gWindow;
 	TTF_Font* sans;
+
+	struct RectBatch
+	{
+		SDL_Color m_Color;
+		std::vector<SDL_Rect> m_Rects;
+	};
+
+	struct QueuedText
+	{
+		const char* m_Text;			// NOT owned, must outlive the batch
+		SDL_Rect m_Rect;
+		SDL_Color m_Color;
+	};
+
+	// Batches are kept (and just emptied) between frames, so that after the
+	// first few frames queueing doesn't allocate.  There are only a handful of
+	// colors, so a linear search for the current one is cheaper than a map.
+	std::vector<RectBatch> m_RectBatches;
+	size_t m_CurrentBatch;
+	std::vector<QueuedText> m_QueuedText;
+
+	SDL_Texture* m_pStaticLayer;		// NULL if it needs to be (re)built
+	bool m_bStaticLayerSupported;
+	bool m_bVSync;
+
+	static bool s_bOffscreen;
+	SDL_Surface* m_pTargetSurface;		// what we render into when offscreen
+
+	FrameCapture* m_pCapture;			// NULL unless capturing
+	int m_CaptureEveryNTicks;
+	std::set<uint64_t> m_CaptureTicks;
+	uint64_t m_FrameTick;				// tick of the snapshot being drawn
+
+	SDL_Surface* m_pGlyphSurface;		// used to build cached strings
+	SDL_Texture* m_pGlyphTexture;		// used by drawDynamicText()
+	SDL_Rect m_GlyphRects[kNumGlyphs];	// where each glyph lives in the atlas
+	int m_GlyphHeight;
+
+	// Keyed by the text followed by the RGBA bytes of the color
+	std::unordered_map<std::string, SDL_Texture*> m_TextCache;
 };
\ No newline at end of file
@@ -0,0 +1,230 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "JobSystem.h"
+
+#include "FrameArena.h"
+#include "Profiler.h"
+#include "SimStats.h"
+
+#include <algorithm>
+#include <assert.h>
+
+JobSystem* Singleton<JobSystem>::s_Obj = NULL;
+
+JobSystem::JobSystem()
+    : m_Generation(0)
+    , m_bStopping(false)
+    , m_pFunc(NULL)
+    , m_NumPending(0)
+{
+    startWorkers(0);
+}
+
+JobSystem::~JobSystem()
+{
+    stopWorkers();
+}
+
+void JobSystem::setNumThreads(unsigned int numThreads)
+{
+    stopWorkers();
+    startWorkers(numThreads);
+}
+
+void JobSystem::startWorkers(unsigned int numThreads)
+{
+    assert(m_Workers.empty());
+
+    if (numThreads == 0)
+    {
+        // hardware_concurrency() is allowed to return 0 if it can't tell
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Singleton::get() isn't thread safe, so create the ones that jobs use
+    // before there are any workers to race each other to it.
+    Profiler::get();
+    SimStats::get();
+
+    m_Queues.clear();
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        m_Queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue));
+    }
+
+    for (unsigned int i = 1; i < numThreads; ++i)
+    {
+        m_Workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+    }
+}
+
+void JobSystem::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bStopping = true;
+    }
+    m_Wake.notify_all();
+
+    for (std::thread& worker : m_Workers)
+    {
+        worker.join();
+    }
+    m_Workers.clear();
+
+    m_bStopping = false;
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const RangeFunc& func)
+{
+    assert(!m_pFunc);       // no nesting, and only one caller at a time
+
+    if (count == 0)
+        return;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    if ((m_Queues.size() == 1) || (count <= grainSize))
+    {
+        func(0, count);
+        return;
+    }
+
+    const size_t numJobs = (count + grainSize - 1) / grainSize;
+    m_pFunc = &func;
+    m_NumPending = numJobs;
+
+    // Deal each thread a contiguous share of the jobs up front, so that they
+    // only need to steal once their own share is gone.
+    const size_t numQueues = m_Queues.size();
+    for (size_t q = 0; q < numQueues; ++q)
+    {
+        WorkQueue& queue = *m_Queues[q];
+        std::lock_guard<std::mutex> lock(queue.m_Mutex);
+        for (size_t i = numJobs * q / numQueues; i < numJobs * (q + 1) / numQueues; ++i)
+        {
+            Job job = { i * grainSize, std::min(count, (i + 1) * grainSize) };
+            queue.m_Jobs.push_back(job);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_Generation;
+    }
+    m_Wake.notify_all();
+
+    runJobs(0);
+
+    // Our own jobs are done, but others may still be running stolen ones
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Done.wait(lock, [this] { return m_NumPending == 0; });
+    }
+
+    m_pFunc = NULL;
+}
+
+void JobSystem::workerLoop(unsigned int queueIndex)
+{
+    Profiler::get().setThreadName("Job Worker");
+
+    uint64_t lastGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [this, lastGeneration] { return m_bStopping || (m_Generation != lastGeneration); });
+            if (m_bStopping)
+                return;
+            lastGeneration = m_Generation;
+        }
+
+        runJobs(queueIndex);
+    }
+}
+
+void JobSystem::runJobs(unsigned int queueIndex)
+{
+    Job job;
+    while (popJob(queueIndex, job) || stealJob(queueIndex, job))
+    {
+        // NOTE: m_pFunc was set before the job was queued, and the queue's
+        // mutex makes sure that we see it.
+        (*m_pFunc)(job.m_Begin, job.m_End);
+
+        // Nothing from the job's scratch memory survives it.  The caller's
+        // arena is left alone, since it belongs to the whole tick.
+        if (queueIndex != 0)
+        {
+            FrameArena::getThreadArena().reset();
+        }
+
+        if (--m_NumPending == 0)
+        {
+            // Take the lock so that the caller can't miss the notification
+            // between checking m_NumPending and going to sleep.
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Done.notify_all();
+        }
+    }
+}
+
+bool JobSystem::popJob(unsigned int queueIndex, Job& job)
+{
+    WorkQueue& queue = *m_Queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.m_Mutex);
+    if (queue.m_Front == queue.m_Jobs.size())
+        return false;
+
+    job = queue.m_Jobs.back();
+    queue.m_Jobs.pop_back();
+    if (queue.m_Front == queue.m_Jobs.size())
+    {
+        queue.m_Jobs.clear();
+        queue.m_Front = 0;
+    }
+    return true;
+}
+
+bool JobSystem::stealJob(unsigned int thiefIndex, Job& job)
+{
+    // Start with our neighbor, so that the thieves spread out
+    const size_t numQueues = m_Queues.size();
+    for (size_t i = 1; i < numQueues; ++i)
+    {
+        WorkQueue& victim = *m_Queues[(thiefIndex + i) % numQueues];
+        std::lock_guard<std::mutex> lock(victim.m_Mutex);
+        if (victim.m_Front < victim.m_Jobs.size())
+        {
+            job = victim.m_Jobs[victim.m_Front++];
+            if (victim.m_Front == victim.m_Jobs.size())
+            {
+                victim.m_Jobs.clear();
+                victim.m_Front = 0;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
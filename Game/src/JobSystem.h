@@ -0,0 +1,114 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Singleton.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// Spreads loops across a pool of worker threads.  Every thread that runs jobs
+// (the one calling parallelFor() included) has a deque of its own.  It takes
+// jobs from the back of its own deque and, when that runs dry, steals from the
+// front of someone else's.  So when some jobs take much longer than others
+// (a Rogue checking whether it's hidden vs. a Swordsman picking a target),
+// the threads that finish early help out instead of sitting idle.
+//
+// Worker threads reset their FrameArena after every job, so scratch memory
+// from the arena mustn't outlive the job that allocated it.
+//
+// NOTE: parallelFor() must only be called from one thread (the simulation's),
+// and never from inside a job.
+class JobSystem : public Singleton<JobSystem>
+{
+public:
+    // Each job gets a [begin, end) slice of the loop.
+    typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+    // Starts one thread per core.
+    JobSystem();
+    virtual ~JobSystem();
+
+    // The number of threads that run jobs, counting the one that calls 
+    // parallelFor().  1 runs everything on the caller, 0 means one per core.
+    void setNumThreads(unsigned int numThreads);
+    unsigned int getNumThreads() const { return (unsigned int)m_Queues.size(); }
+
+    // Splits [0, count) into jobs of at most grainSize and returns once they've
+    // all run.  They may run in any order and on any thread, so func must give
+    // the same results either way (e.g. by only writing to the items in its 
+    // slice).
+    void parallelFor(size_t count, size_t grainSize, const RangeFunc& func);
+
+private:
+    struct Job
+    {
+        size_t m_Begin;
+        size_t m_End;
+    };
+
+    // A deque, but kept in a vector so that refilling it every tick doesn't
+    // allocate.  The live jobs are m_Jobs[m_Front] to the back.
+    struct WorkQueue
+    {
+        WorkQueue() : m_Front(0) {}
+
+        std::mutex m_Mutex;
+        std::vector<Job> m_Jobs;
+        size_t m_Front;
+    };
+
+    void startWorkers(unsigned int numThreads);
+    void stopWorkers();
+    void workerLoop(unsigned int queueIndex);
+
+    // Keeps taking jobs (our own first, then stolen ones) until there are
+    // none left anywhere.
+    void runJobs(unsigned int queueIndex);
+    bool popJob(unsigned int queueIndex, Job& job);
+    bool stealJob(unsigned int thiefIndex, Job& job);
+
+private:
+    std::vector<std::unique_ptr<WorkQueue> > m_Queues;     // [0] belongs to the caller
+    std::vector<std::thread> m_Workers;                     // worker i uses m_Queues[i + 1]
+
+    std::mutex m_Mutex;             // guards m_Generation and m_bStopping
+    std::condition_variable m_Wake;
+    std::condition_variable m_Done;
+    uint64_t m_Generation;          // bumped for every parallelFor(), to wake the workers
+    bool m_bStopping;
+
+    const RangeFunc* m_pFunc;       // the loop being run, if any
+    std::atomic<size_t> m_NumPending;
+
+private:
+    // DELIBERATELY UNDEFINED
+    JobSystem(const JobSystem& rhs);
+    JobSystem& operator=(const JobSystem& rhs);
+};
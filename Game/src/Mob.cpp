@@ -25,29 +25,115 @@
 #include "Constants.h"
 #include "Game.h"
 #include "HelperFunctions.h"
+#include "Profiler.h"
+#include "SimStats.h"
+#include "SpatialKernels.h"
 
 #include <algorithm>
 #include <vector>
 
+// How often (in ticks) each Rogue checks whether it's hidden while 
+// TickBudget::DeferRogueVisibility is on
+static const uint64_t kDeferredVisibilityInterval = 4;
+
 
 Mob::Mob(const iEntityStats &stats, const Vec2 &pos, bool isNorth)
-        : Entity(stats, pos, isNorth), m_pWaypoint(NULL) {
+        : Entity(stats, pos, isNorth), m_pWaypoint(NULL), m_bSensedHidden(false), m_bAsleep(false), m_SleepCell(0),
+          m_SleepEvents(0) {
     assert(dynamic_cast<const iEntityStats_Mob *>(&stats) != NULL);
 }
 
+void Mob::decide() {
+    // If nothing has happened near us since we fell asleep, then there's
+    // still nothing to target.
+    if (m_bAsleep && (m_Cell == m_SleepCell) && (sumSleepEvents() == m_SleepEvents)) {
+        m_DecisionTick = Game::get().getTickCount();
+        return;
+    }
+
+    Entity::decide();
+
+    // Hiding is the most expensive thing a Rogue senses, so it's done here,
+    // where it can run in parallel.  Over budget, each Rogue only checks on
+    // some ticks, and they take turns.
+    if (this->getStats().getMobType() == iEntityStats::MobType::Rogue) {
+        Game &game = Game::get();
+        if (!game.getTickBudget().isActive(TickBudget::DeferRogueVisibility) ||
+            (((game.getTickCount() + m_Handle.getIndex()) % kDeferredVisibilityInterval) == 0)) {
+            m_bSensedHidden = isHidden();
+        }
+    }
+
+    m_bAsleep = canSleep();
+    if (m_bAsleep) {
+        m_SleepCell = m_Cell;
+        m_SleepEvents = sumSleepEvents();
+    }
+}
+
+bool Mob::canSleep() const {
+    // Rogues are always sensing their allies and enemies, to hide
+    if (!m_Target.isNull() || (this->getStats().getMobType() == iEntityStats::MobType::Rogue)) {
+        return false;
+    }
+
+    // Enemies matter if we could see them, allies only if we could bump into
+    // them.  Either way the margin covers whatever can move toward us before
+    // the EventGrid tells us about it.
+    SimStats::get().count(SimStats::SpatialQueries);
+    Game &game = Game::get();
+    const Player &enemy = game.getPlayer(!m_bNorth);
+    float enemyReach = getSleepRadius(false);
+    if (SpatialKernels::anyWithinReach(enemy.getPackedBuildings(), m_Pos, enemyReach) ||
+        SpatialKernels::anyWithinReach(enemy.getPackedMobs(), m_Pos, enemyReach)) {
+        return false;
+    }
+
+    // Our own pack includes us.  Our towers are in the ObstacleField, which
+    // walkPath() still resolves against.
+    const Player &ally = game.getPlayer(m_bNorth);
+    float allyReach = getSleepRadius(true);
+    FrameVector<Entity *> nearby;
+    SpatialKernels::findAllWithin(ally.getPackedMobs(), m_Pos, allyReach, nearby);
+    return nearby.size() <= 1;
+}
+
+float Mob::getSleepRadius(bool bAllies) const {
+    // No mob is more than a tile across, so allies further than a tile plus
+    // the margin can't be touching us.
+    return MOB_SLEEP_MARGIN + (bAllies ? 1.f : m_Stats.getSightRadius());
+}
+
+uint64_t Mob::sumSleepEvents() const {
+    const EventGrid &grid = Game::get().getEventGrid();
+    return grid.sumEvents(!m_bNorth, m_Cell, getSleepRadius(false)) +
+           grid.sumEvents(m_bNorth, m_Cell, getSleepRadius(true));
+}
+
 void Mob::tick(float deltaTSec) {
+    PROFILE_SCOPE("Mob::tick");
+
+    // With no target and nothing to bump into, this is all that the rest of 
+    // the tick would do.
+    if (isAsleep()) {
+        SimStats::get().count(SimStats::SleepingMobTicks);
+        walkPath(deltaTSec);
+        updateCell();
+        return;
+    }
+
     // Tick the entity first.  This will pick our target, and attack it if it's in range.
     Entity::tick(deltaTSec);
 
     // calculate the hidden time
     if (this->getStats().getMobType() == iEntityStats::MobType::Rogue) {
-        m_chargeSpringAttack = m_hiddenTime >= 2.f;
+        m_chargeSpringAttack = m_bInvisible;
 
-        if (isHidden()) {
-            // std::cout << "Hide: " << m_hiddenTime << std::endl;
-            m_hiddenTime += deltaTSec;
+        bool bHidden = hasDecided() ? m_bSensedHidden : isHidden();
+        if (bHidden) {
+            startHiding();
         } else {
-            m_hiddenTime = 0.f;
+            stopHiding();
         }
     }
 
@@ -56,17 +142,24 @@ void Mob::tick(float deltaTSec) {
         move(deltaTSec);
     }     // if target is in the range, don't move towards it but still check for the collision
     else {
-        std::vector<Entity *> otherEntities = checkCollision();
-        for (Entity *e: otherEntities) {
-            if (e) {
-                processCollision(e, deltaTSec, Vec2(0, 0));
+        if (isCollisionTick()) {
+            FrameVector<Entity *> otherEntities = checkCollision();
+            for (Entity *e: otherEntities) {
+                if (e) {
+                    processCollision(e, deltaTSec, Vec2(0, 0));
+                }
             }
         }
-        handleEdgeCollsion(Vec2(0, 0));
+        resolveObstacles();
     }
+
+    updateCell();
 }
 
 bool Mob::isHidden() const {
+    PROFILE_SCOPE("Mob::isHidden");
+    ScopedSimTimer timer(SimStats::IsHidden);
+
     // Project 2: This is where you should put the logic for checking if a Rogue is
     // hidden or not.  It probably involves something related to calling Game::Get()
     // to get the Game, then calling getPlayer() on the game to get each player, then
@@ -82,11 +175,11 @@ bool Mob::isHidden() const {
 
 
     // search for the giants for possible shelter to block sight
-    std::vector<Entity *> possibleNoticeEntities = entityNoticeThisMob();
+    FrameVector<Entity *> possibleNoticeEntities = entityNoticeThisMob();
 
-    std::vector<Entity *> allyEntities = std::vector<Entity *>();
-    std::vector<Entity *> allyMobs = Game::get().getMobs(this->isNorth());
-    std::vector<Entity *> allyBuildings = Game::get().getBuildings(this->isNorth());
+    FrameVector<Entity *> allyEntities;
+    const std::vector<Entity *>& allyMobs = Game::get().getMobs(this->isNorth());
+    const std::vector<Entity *>& allyBuildings = Game::get().getBuildings(this->isNorth());
 
     for (Entity *e: allyMobs) {
         if (e->getStats().getName() == "Giant") {
@@ -134,6 +227,9 @@ bool Mob::isHidden() const {
 }
 
 void Mob::move(float deltaTSec) {
+    PROFILE_SCOPE("Mob::move");
+    ScopedSimTimer timer(SimStats::Move);
+
     // Project 2: You'll likely need to do some work in this function to get the
     // Rogue to move correctly (i.e. hide behind Giant or Tower, move with the Giant,
     // spring out when doing a sneak attack, etc).
@@ -149,9 +245,10 @@ void Mob::move(float deltaTSec) {
     // If we have a target and it's on the same side of the river, we move towards it.
     //  Otherwise, we move toward the bridge.
     bool bMoveToTarget = false;
-    if (!!m_pTarget) {
+    Entity* pTarget = getTarget();
+    if (!!pTarget) {
         bool imTop = m_Pos.y < (GAME_GRID_HEIGHT / 2);
-        bool otherTop = m_pTarget->getPosition().y < (GAME_GRID_HEIGHT / 2);
+        bool otherTop = pTarget->getPosition().y < (GAME_GRID_HEIGHT / 2);
 
         if (imTop == otherTop) {
             bMoveToTarget = true;
@@ -161,7 +258,7 @@ void Mob::move(float deltaTSec) {
     Vec2 destPos;
     if (bMoveToTarget) {
         m_pWaypoint = NULL;
-        destPos = m_pTarget->getPosition();
+        destPos = pTarget->getPosition();
     } else {
         if (!m_pWaypoint) {
             m_pWaypoint = pickWaypoint();
@@ -172,12 +269,12 @@ void Mob::move(float deltaTSec) {
     // Actually do the moving
     Vec2 moveVec = destPos - m_Pos;
     float distRemaining = moveVec.normalize();
-    float moveDist = m_Stats.getSpeed() * deltaTSec;
+    float moveDist = m_Stats.getSpeed() * getHasteMultiplier() * deltaTSec;
 
-    // if we're moving to m_pTarget, don't move into it
+    // if we're moving to our target, don't move into it
     if (bMoveToTarget) {
-        assert(m_pTarget);
-        distRemaining -= (m_Stats.getSize() + m_pTarget->getStats().getSize()) / 2.f;
+        assert(pTarget);
+        distRemaining -= (m_Stats.getSize() + pTarget->getStats().getSize()) / 2.f;
         distRemaining = std::max(0.f, distRemaining);
     }
 
@@ -185,12 +282,25 @@ void Mob::move(float deltaTSec) {
     if (this->getStats().getMobType() == iEntityStats::MobType::Rogue) {
         // std::cout << "-----------------Rogue---------------------------\n";
 
-        if (m_hiddenTime >= 2.f && distRemaining < this->getStats().getSpringRange() && bMoveToTarget) {
-            m_Pos = distRemaining < this->getStats().getSpringSpeed() ?
+        if (m_bInvisible && distRemaining < this->getStats().getSpringRange() && bMoveToTarget) {
+            Vec2 startPos = m_Pos;
+            sweepTo(distRemaining < this->getStats().getSpringSpeed() ?
                     m_Pos + moveVec * distRemaining :
-                    m_Pos + moveVec * this->getStats().getSpringSpeed();
+                    m_Pos + moveVec * this->getStats().getSpringSpeed());
+            sweepMobs(startPos);
+
+            // sweepMobs() may have left us inside whoever we sprang through,
+            // so push apart now rather than on some later collision tick
+            FrameVector<Entity *> otherEntities = checkCollision();
+            for (Entity *e: otherEntities) {
+                if (e) {
+                    processCollision(e, deltaTSec, moveVec);
+                }
+            }
+            resolveObstacles();
 
-            m_hiddenTime = 0.f;
+            // springing gives us away, so we have to start hiding over
+            stopHiding();
 
             // std::cout << "spring and attack an enemy";
 
@@ -198,14 +308,11 @@ void Mob::move(float deltaTSec) {
         }
 
         // if it is not hidden, go to the closest target
-        if (!targetInRange() && m_hiddenTime != 0) {
+        if (!targetInRange() && m_bHiding) {
             // search for giants and towers, hide if they are within range
-            std::vector<Entity *> collidingEntities = std::vector<Entity *>();
-
             // get all the entities include buildings and mobs
-            std::vector<Entity *> entities = std::vector<Entity *>();
-            std::vector<Entity *> mobs = Game::get().getMobs(this->isNorth());
-            std::vector<Entity *> buildings = Game::get().getBuildings(this->isNorth());
+            const std::vector<Entity *>& mobs = Game::get().getMobs(this->isNorth());
+            const std::vector<Entity *>& buildings = Game::get().getBuildings(this->isNorth());
 
             // the closest distance from rogue to shelter
             float closestDistance = 999;
@@ -272,26 +379,13 @@ void Mob::move(float deltaTSec) {
 
                     // this move should appear when there is no enemies on sight
                     if (inFrontTower && enemiesInSight().size() == 0) {
-                        if (moveDist <= distRemaining) {
-                            // if the mob will collid with the edge in the next tick, handle the collision
-                            if (!handleEdgeCollsion(moveVec * moveDist)) {
-                                // else, move the mob
-                                m_Pos += moveVec * moveDist;
-                            }
-                        }
-                        else {
-                            // if the mob will collid with the edge in the next tick, handle the collision
-                            if (!handleEdgeCollsion(moveVec * distRemaining)) {
-                                // else, move the mob
-                                m_Pos += moveVec * distRemaining;
-                            }
-                        }
+                        sweepTo(m_Pos + moveVec * std::min(moveDist, distRemaining));
                     }
 
                     return;
                 } else {
                     // neither hide behind a giant nor building, moving towards closest giant or building
-                    std::vector<Entity *> entitiesInSight = seekEntityWithinRadius(this->getStats().getSightRadius(),
+                    FrameVector<Entity *> entitiesInSight = seekEntityWithinRadius(this->getStats().getSightRadius(),
                                                                                    this->isNorth());
 
                     // find the giant closest and within sight range
@@ -314,7 +408,7 @@ void Mob::move(float deltaTSec) {
 
                     // if not find the giant, go to the closest building
                     if (!findGiant) {
-                        std::vector<Entity *> allyBuildings = Game::get().getBuildings(this->isNorth());
+                        const std::vector<Entity *>& allyBuildings = Game::get().getBuildings(this->isNorth());
                         for (auto e: allyBuildings) {
                             float distanceToTower = euclidDistance(this->getPosition(), e->getPosition());
 
@@ -336,40 +430,170 @@ void Mob::move(float deltaTSec) {
         }
     }
 
-    if (moveDist <= distRemaining) {
-        // if the mob will collid with the edge in the next tick, handle the collision
-        if (!handleEdgeCollsion(moveVec * moveDist)) {
-            // else, move the mob
-            m_Pos += moveVec * moveDist;
+    Vec2 startPos = m_Pos;
+    stepToward(moveVec, distRemaining, moveDist);
+
+    // Project 1: This is where your collision code will be called from
+    // Move process Collision before move
+    if (!isCollisionTick()) {
+        return;
+    }
+    sweepMobs(startPos);
+    FrameVector<Entity *> otherEntities = checkCollision();
+
+    // get all the entities that may collide with the mob
+    for (Entity *e: otherEntities) {
+        if (e) {
+            // handle each collision
+            processCollision(e, deltaTSec, moveVec);
         }
+    }
+
+    // the pushes above don't know about the river, the towers or the edges
+    resolveObstacles();
+}
+
+bool Mob::isCollisionTick() const {
+    // Over budget, half of the mobs check on even ticks and half on odd ones
+    Game &game = Game::get();
+    return !game.getTickBudget().isActive(TickBudget::HalveCollisionChecks) ||
+           (((game.getTickCount() + m_Handle.getIndex()) & 1) == 0);
+}
+
+// The kinematic step for a sleeping mob.  This is what move() does when we
+// have no target and aren't a Rogue, minus the collision checks.
+void Mob::walkPath(float deltaTSec) {
+    PROFILE_SCOPE("Mob::walkPath");
+    ScopedSimTimer timer(SimStats::Move);
+
+    if (!m_pWaypoint) {
+        m_pWaypoint = pickWaypoint();
+    }
+    Vec2 destPos = m_pWaypoint ? *m_pWaypoint : m_Pos;
+
+    Vec2 moveVec = destPos - m_Pos;
+    float distRemaining = moveVec.normalize();
+    stepToward(moveVec, distRemaining, m_Stats.getSpeed() * getHasteMultiplier() * deltaTSec);
+}
+
+void Mob::stepToward(Vec2 &moveVec, float distRemaining, float moveDist) {
+    if (moveDist <= distRemaining) {
+        sweepTo(m_Pos + moveVec * moveDist);
     } else {
-        // if the mob will collid with the edge in the next tick, handle the collision
-        if (!handleEdgeCollsion(moveVec * distRemaining)) {
-            // else, move the mob
-            m_Pos += moveVec * distRemaining;
-        }
+        sweepTo(m_Pos + moveVec * distRemaining);
 
         // if the destination was a waypoint, find the next one and continue movement
         if (m_pWaypoint) {
             m_pWaypoint = pickWaypoint();
-            destPos = m_pWaypoint ? *m_pWaypoint : m_Pos;
+            Vec2 destPos = m_pWaypoint ? *m_pWaypoint : m_Pos;
             moveVec = destPos - m_Pos;
             moveVec.normalize();
-            m_Pos += moveVec * distRemaining;
+            sweepTo(m_Pos + moveVec * distRemaining);
         }
     }
+}
 
-    // Project 1: This is where your collision code will be called from
-    // Move process Collision before move
-    std::vector<Entity *> otherEntities = checkCollision();
+void Mob::pullToward(const Vec2 &center, float dist) {
+    Vec2 moveVec = center - m_Pos;
+    float distRemaining = moveVec.normalize();
+    sweepTo(m_Pos + moveVec * std::min(dist, distRemaining));
+    updateCell();
+}
 
-    // get all the entities that may collide with the mob
-    for (Entity *e: otherEntities) {
-        if (e) {
-            // handle each collision
-            processCollision(e, deltaTSec, moveVec);
+// Pushes us out of the river, the towers, and off the edges of the arena
+bool Mob::resolveObstacles() {
+    return Game::get().getObstacleField().resolve(m_Pos, m_Stats.getSize() / 2.f);
+}
+
+// Moves us toward destPos without passing through any of the above on the way,
+// however long the tick was.
+bool Mob::sweepTo(const Vec2 &destPos) {
+    return Game::get().getObstacleField().sweep(m_Pos, destPos, m_Stats.getSize() / 2.f);
+}
+
+// Where a point moving from startPos by moveVec enters and leaves the square of
+// the given half width around center, as fractions of moveVec.  Returns false 
+// if it never does.
+static bool sweepBox(const Vec2 &startPos, const Vec2 &moveVec, const Vec2 &center, float halfWidth,
+                     float &enter, float &exit) {
+    enter = -FLT_MAX;
+    exit = FLT_MAX;
+
+    const float start[2] = {startPos.x - center.x, startPos.y - center.y};
+    const float move[2] = {moveVec.x, moveVec.y};
+    for (int axis = 0; axis < 2; axis++) {
+        if (move[axis] == 0.f) {
+            if (fabsf(start[axis]) >= halfWidth) {
+                return false;
+            }
+            continue;
+        }
+
+        float t0 = (-halfWidth - start[axis]) / move[axis];
+        float t1 = (halfWidth - start[axis]) / move[axis];
+        enter = std::max(enter, std::min(t0, t1));
+        exit = std::min(exit, std::max(t0, t1));
+    }
+
+    return (enter < exit) && (enter < 1.f) && (exit > 0.f);
+}
+
+static float findSmallestMobSize() {
+    float smallest = FLT_MAX;
+    for (int i = 0; i < iEntityStats::numMobTypes; i++) {
+        smallest = std::min(smallest, iEntityStats::getStats((iEntityStats::MobType)i).getSize());
+    }
+    return smallest;
+}
+
+// checkCollision() only sees the mobs that we overlap once we've moved, so a 
+// long enough step (a spring attack, or a long tick) can carry us clean 
+// through one.  If that happens with a mob heavy enough to stop us, this backs
+// us up to where we were deepest inside it, so that processCollision() deals 
+// with it just as it would have with shorter steps.
+void Mob::sweepMobs(const Vec2 &startPos) {
+    Vec2 moveVec = m_Pos - startPos;
+    float moveDist = moveVec.length();
+
+    // A move no longer than the half width of a box can only have clipped 
+    // its corner, which checkCollision() has never cared about either.
+    static const float s_SmallestMobSize = findSmallestMobSize();
+    if (moveDist <= (m_Stats.getSize() + s_SmallestMobSize) / 2.f) {
+        return;
+    }
+
+    float firstEnter = FLT_MAX;
+    float firstT = 1.f;
+    for (int i = 0; i < 2; i++) {
+        for (Entity *e: Game::get().getMobs(i == 1)) {
+            float sizeAverage = (m_Stats.getSize() + e->getStats().getSize()) / 2;
+            if ((e == this) || (moveDist <= sizeAverage) || (e->getStats().getMass() < m_Stats.getMass())) {
+                continue;
+            }
+
+            // When we were in the same box that checkCollision() tests, as a
+            // fraction of the move
+            float enter, exit;
+            if (!sweepBox(startPos, moveVec, e->getPosition(), sizeAverage, enter, exit)) {
+                continue;
+            }
+
+            // Inside it at either end is checkCollision()'s problem
+            if ((enter > 0.f) && (exit < 1.f) && (enter < firstEnter)) {
+                firstEnter = enter;
+                firstT = (enter + exit) / 2.f;
+            }
         }
     }
+
+    if (firstEnter < FLT_MAX) {
+        m_Pos = startPos + moveVec * firstT;
+
+        // NOTE: If the sweep slid us along an obstacle then we didn't actually
+        // come this way, and the straight line can cut through the river or a
+        // tower.
+        resolveObstacles();
+    }
 }
 
 const Vec2 *Mob::pickWaypoint() {
@@ -404,26 +628,21 @@ const Vec2 *Mob::pickWaypoint() {
     }
 }
 
-// Project 1: 
-//  1) return a vector of mobs that we're colliding with
-//  2) handle collision with towers & river 
-// change the return type of the checkCollision to a vector
-std::vector<Entity *> Mob::checkCollision() {
-    std::vector<Entity *> collidingEntities = std::vector<Entity *>();
+// Returns the mobs that we're colliding with.  The towers and the river are
+// handled by resolveObstacles(), since they never move.
+FrameVector<Entity *> Mob::checkCollision() {
+    PROFILE_SCOPE("Mob::checkCollision");
+    ScopedSimTimer timer(SimStats::Collision);
+
+    FrameVector<Entity *> collidingEntities;
 
 
     // check collision north and south
     for (int i = 0; i < 2; i++) {
         bool northOrSouth = (i == 1);
 
-        // get all the entities include buildings and mobs
-        std::vector<Entity *> entities = std::vector<Entity *>();
-        std::vector<Entity *> mobs = Game::get().getMobs(northOrSouth);
-        std::vector<Entity *> buildings = Game::get().getBuildings(northOrSouth);
-        entities.insert(entities.end(), mobs.begin(), mobs.end());
-        entities.insert(entities.end(), buildings.begin(), buildings.end());
-
-        for (const Entity *e: entities) {
+        const std::vector<Entity *>& mobs = Game::get().getMobs(northOrSouth);
+        for (Entity *e: mobs) {
             // get all the mobs in the radius of average size
             float sizeAverage = (m_Stats.getSize() + e->getStats().getSize()) / 2;
             float xDif = abs(this->getPosition().x - e->getPosition().x);
@@ -433,28 +652,28 @@ std::vector<Entity *> Mob::checkCollision() {
                 // ignore this
                 continue;
             } else if (xDif < sizeAverage && yDif < sizeAverage) {
-                Entity *entityFound = new Entity(e->getStats(), e->getPosition(), e->isNorth());
-                collidingEntities.push_back(entityFound);
+                collidingEntities.push_back(e);
             }
 
             // project 1: your code checking for a collision goes here
         }
     }
 
+    SimStats& simStats = SimStats::get();
+    simStats.count(SimStats::SpatialQueries);
+    simStats.count(SimStats::CollisionPairs, collidingEntities.size());
+
     return collidingEntities;
 }
 
 // handle the collision of entities
 void Mob::processCollision(Entity *otherEntity, float deltaTSec, Vec2 moveVec) {
+    PROFILE_SCOPE("Mob::processCollision");
+    ScopedSimTimer timer(SimStats::Collision);
 
-    // PROJECT 1: YOUR COLLISION HANDLING CODE GOES HERE
-    float otherEntityMass = 0.f;
 
-    if (otherEntity->getStats().getName() == "Princess Tower" || otherEntity->getStats().getName() == "King Tower") {
-        otherEntityMass = 999.f;
-    } else {
-        otherEntityMass = otherEntity->getStats().getMass();
-    }
+    // PROJECT 1: YOUR COLLISION HANDLING CODE GOES HERE
+    float otherEntityMass = otherEntity->getStats().getMass();
 
     if (this->getStats().getMass() > otherEntityMass) {
         // If mass larger than the colliding mob, do nothing
@@ -477,59 +696,46 @@ void Mob::processCollision(Entity *otherEntity, float deltaTSec, Vec2 moveVec) {
     }
 }
 
-std::vector<Entity *> Mob::entityNoticeThisMob() const {
-    std::vector<Entity *> awareEntities = std::vector<Entity *>();
+FrameVector<Entity *> Mob::entityNoticeThisMob() const {
+    FrameVector<Entity *> awareEntities;
 
     bool enemySide = !this->isNorth();
 
     // get all the entities include buildings and mobs
-    std::vector<Entity *> entities = std::vector<Entity *>();
-    std::vector<Entity *> mobs = Game::get().getMobs(enemySide);
-    std::vector<Entity *> buildings = Game::get().getBuildings(enemySide);
+    FrameVector<Entity *> entities;
+    const std::vector<Entity *>& mobs = Game::get().getMobs(enemySide);
+    const std::vector<Entity *>& buildings = Game::get().getBuildings(enemySide);
+    entities.reserve(mobs.size() + buildings.size());
     entities.insert(entities.end(), mobs.begin(), mobs.end());
     entities.insert(entities.end(), buildings.begin(), buildings.end());
 
-    for (const Entity *e: entities) {
+    for (Entity *e: entities) {
         // get all the mobs in the radius of average size
         float distance = euclidDistance(this->getPosition(), e->getPosition());
 
         if (distance < e->getStats().getSightRadius()) {
-            Entity *entityFound = new Entity(e->getStats(), e->getPosition(), e->isNorth());
-            awareEntities.push_back(entityFound);
+            awareEntities.push_back(e);
         }
     }
 
+    SimStats::get().count(SimStats::SpatialQueries);
     return awareEntities;
 }
 
-std::vector<Entity *> Mob::enemiesInSight() const {
-    std::vector<Entity *> awareEntities = std::vector<Entity *>();
-
-    bool enemySide = !this->isNorth();
-
-    // get all the entities include buildings and mobs
-    std::vector<Entity *> entities = std::vector<Entity *>();
-    std::vector<Entity *> mobs = Game::get().getMobs(enemySide);
-    std::vector<Entity *> buildings = Game::get().getBuildings(enemySide);
-    entities.insert(entities.end(), mobs.begin(), mobs.end());
-    entities.insert(entities.end(), buildings.begin(), buildings.end());
+FrameVector<Entity *> Mob::enemiesInSight() const {
+    FrameVector<Entity *> awareEntities;
 
-    for (const Entity *e: entities) {
-        // get all the mobs in the radius of average size
-        float xDif = abs(this->getPosition().x - e->getPosition().x);
-        float yDif = abs(this->getPosition().y - e->getPosition().y);
-        float euclidDistance = sqrt(xDif * xDif + yDif * yDif);
-
-        if (euclidDistance < this->getStats().getSightRadius()) {
-            Entity *entityFound = new Entity(e->getStats(), e->getPosition(), e->isNorth());
-            awareEntities.push_back(entityFound);
-        }
-    }
+    // get all the live enemy mobs and buildings within our sight radius
+    const Player &enemy = Game::get().getPlayer(!this->isNorth());
+    const float sightRadius = this->getStats().getSightRadius();
+    SpatialKernels::findAllWithin(enemy.getPackedMobs(), m_Pos, sightRadius, awareEntities);
+    SpatialKernels::findAllWithin(enemy.getPackedBuildings(), m_Pos, sightRadius, awareEntities);
 
+    SimStats::get().count(SimStats::SpatialQueries);
     return awareEntities;
 }
 
-void Mob::moveAround(std::vector<Entity *> enemySpotted, Vec2 shelterPos, float shelterSize, float moveDist,
+void Mob::moveAround(const FrameVector<Entity *>& enemySpotted, Vec2 shelterPos, float shelterSize, float moveDist,
                      bool hideGiant, float deltaTSec, Vec2 moveVec) {
     Vec2 finalPos = Vec2(0, 0);
     Vec2 finalMove = Vec2(0, 0);
@@ -555,7 +761,7 @@ void Mob::moveAround(std::vector<Entity *> enemySpotted, Vec2 shelterPos, float
     m_Pos = finalPos + toShelterVec * toShelterDis;
 
     // Move process Collision before move
-    std::vector<Entity *> otherEntities = checkCollision();
+    FrameVector<Entity *> otherEntities = checkCollision();
 
     // get all the entities that may collide with the mob
     for (Entity *e: otherEntities) {
@@ -564,139 +770,29 @@ void Mob::moveAround(std::vector<Entity *> enemySpotted, Vec2 shelterPos, float
             processCollision(e, deltaTSec, moveVec);
         }
     }
-
+    resolveObstacles();
 }
 
-std::vector<Entity *> Mob::seekEntityWithinRadius(float radius, bool side) {
-    std::vector<Entity *> returnEntities = std::vector<Entity *>();
+FrameVector<Entity *> Mob::seekEntityWithinRadius(float radius, bool side) {
+    FrameVector<Entity *> returnEntities;
 
     // get all the entities include buildings and mobs
-    std::vector<Entity *> entities = std::vector<Entity *>();
-    std::vector<Entity *> mobs = Game::get().getMobs(side);
-    std::vector<Entity *> buildings = Game::get().getBuildings(side);
+    FrameVector<Entity *> entities;
+    const std::vector<Entity *>& mobs = Game::get().getMobs(side);
+    const std::vector<Entity *>& buildings = Game::get().getBuildings(side);
+    entities.reserve(mobs.size() + buildings.size());
     entities.insert(entities.end(), mobs.begin(), mobs.end());
     entities.insert(entities.end(), buildings.begin(), buildings.end());
 
-    for (const Entity *e: entities) {
+    for (Entity *e: entities) {
         // get all the mobs in the radius of average size
         float eucDis = euclidDistance(e->getPosition(), this->getPosition());
 
         if (eucDis < radius) {
-            Entity *entityFound = new Entity(e->getStats(), e->getPosition(), e->isNorth());
-            returnEntities.push_back(entityFound);
+            returnEntities.push_back(e);
         }
     }
 
+    SimStats::get().count(SimStats::SpatialQueries);
     return returnEntities;
 }
-
-// handle the collision of the edge
-bool Mob::handleEdgeCollsion(Vec2 moveVec) {
-    // get the future position
-    Vec2 futurePos = this->getPosition() + moveVec;
-
-    // since the mobs has a size, add size to consideration
-    if (this->isNorth()) {
-        futurePos.y += this->getStats().getSize() / 2 + 0.1f;
-    } else {
-        futurePos.y -= this->getStats().getSize() / 2 + 0.1f;
-    }
-
-    // handle the collision of the edge on the x scope
-    if (this->getPosition().x < 0) {
-        Vec2 finalDisplacement = Vec2(abs((moveVec * abs(this->getPosition().x - 0)).x), 0.f);
-        m_Pos += finalDisplacement;
-    } else if (this->getPosition().x > GAME_GRID_WIDTH) {
-        Vec2 finalDisplacement = Vec2(abs((moveVec * abs(this->getPosition().x - GAME_GRID_WIDTH)).x), 0.f);
-        m_Pos -= finalDisplacement;
-    }
-
-    // handle the collision of the edge on the y scope
-    if (this->getPosition().y < 0) {
-        Vec2 finalDisplacement = Vec2(0.f, abs((moveVec * abs(this->getPosition().y - 0)).y));
-        m_Pos += finalDisplacement;
-    } else if (this->getPosition().y > GAME_GRID_HEIGHT) {
-        Vec2 finalDisplacement = Vec2(0.f, abs((moveVec * abs(this->getPosition().y - GAME_GRID_WIDTH)).y));
-        m_Pos -= finalDisplacement;
-    }
-
-    // handle the situation which entities is in the river
-    bool nowInTheBridge = false;
-    if (this->getPosition().y > RIVER_TOP_Y && this->getPosition().y < RIVER_BOT_Y) {
-        bool nowInLeftBridge = (this->getPosition().x > (LEFT_BRIDGE_CENTER_X - BRIDGE_WIDTH / 2.f))
-                               && (this->getPosition().x < (LEFT_BRIDGE_CENTER_X + BRIDGE_WIDTH / 2.f));
-        bool nowInRightBridge = (this->getPosition().x > (RIGHT_BRIDGE_CENTER_X - BRIDGE_WIDTH / 2.f))
-                                && (this->getPosition().x < (RIGHT_BRIDGE_CENTER_X + BRIDGE_WIDTH / 2.f));
-
-        // if the entity is on the bridge, pass
-        if (nowInLeftBridge || nowInRightBridge) {
-            nowInTheBridge = true;
-        } else {
-            // else handle the collision with river
-            float xDisPlacement = 0.f;
-            float yDisPlacement;
-
-            // handle the collision of mob horizontally on the left half of the map
-            if (this->getPosition().x < GAME_GRID_WIDTH / 2) {
-                // move the mob to left bridge
-                if (this->getPosition().x < LEFT_BRIDGE_CENTER_X - BRIDGE_WIDTH / 2) {
-                    xDisPlacement = LEFT_BRIDGE_CENTER_X - this->getPosition().x;
-                } else if (this->getPosition().x > LEFT_BRIDGE_CENTER_X + BRIDGE_WIDTH / 2) {
-                    xDisPlacement = abs(LEFT_BRIDGE_CENTER_X - this->getPosition().x) * -1.f;
-                }
-            }
-                // handle the collision of mob horizontally on the right half of the map
-            else {
-                // move the mob to right bridge
-                if (this->getPosition().x < RIGHT_BRIDGE_CENTER_X - BRIDGE_WIDTH / 2) {
-                    xDisPlacement = RIGHT_BRIDGE_CENTER_X - this->getPosition().x;
-                } else if (this->getPosition().x > RIGHT_BRIDGE_CENTER_X + BRIDGE_WIDTH / 2) {
-                    xDisPlacement = abs(RIGHT_BRIDGE_CENTER_X - this->getPosition().x) * -1.f;
-                }
-            }
-
-            // handle the mob on the y axis
-            if (this->getPosition().y < GAME_GRID_HEIGHT / 2) {
-                yDisPlacement = abs(this->getPosition().y - RIVER_TOP_Y) * -1.f;
-            } else {
-                yDisPlacement = abs(this->getPosition().y - RIVER_BOT_Y);
-            }
-
-
-            // since the move vector is too big, mutiply a number in order to let it not exceed the speed
-            Vec2 move = Vec2(xDisPlacement * 0.2f, yDisPlacement);
-            move.normalize();
-            move *= this->getStats().getSpeed();
-            move *= 0.1f;
-            m_Pos += move;
-        }
-    }
-
-    // handle the situation which the mob is not in the river but will move to the river in the next tick
-    if (futurePos.y > RIVER_TOP_Y && futurePos.y < RIVER_BOT_Y) {
-        // std::cout << "---in the river\n---";
-
-        // handle the situation when the mob move into the river from north or south
-        bool inLeftBridge = (futurePos.x > (LEFT_BRIDGE_CENTER_X - BRIDGE_WIDTH / 2.f))
-                            && (futurePos.x < (LEFT_BRIDGE_CENTER_X + BRIDGE_WIDTH / 2.f));
-        bool inRightBridge = (futurePos.x > (RIGHT_BRIDGE_CENTER_X - BRIDGE_WIDTH / 2.f))
-                             && (futurePos.x < (RIGHT_BRIDGE_CENTER_X + BRIDGE_WIDTH / 2.f));
-        if (inLeftBridge || inRightBridge) {
-            return false;
-        } else {
-            // if now on the bridge, just move forward or backward, else just move leftward or rightward
-            if (nowInTheBridge) {
-                m_Pos += Vec2(0.f, moveVec.y);
-            } else {
-                m_Pos += Vec2(moveVec.x, 0.f);
-            }
-
-            return true;
-        }
-    } else {
-        return false;
-    }
-
-}
-
-
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "Entity.h"
+#include "FrameArena.h"
 
 struct Waypoint;
 
@@ -31,20 +32,48 @@ class Mob : public Entity {
 public:
     Mob(const iEntityStats& stats, const Vec2& pos, bool isNorth);
 
+    virtual void decide();
     virtual void tick(float deltaTSec);
 
     virtual bool isHidden() const;
+
+    // True if nothing was near enough to sense or bump into at the start of
+    // this tick, so all we do is walk our path.
+    bool isAsleep() const { return m_bAsleep && hasDecided(); }
+
+    // Spells: drags us up to dist toward center, without going through any 
+    // obstacles on the way
+    void pullToward(const Vec2& center, float dist);
+
 protected:
     void move(float deltaTSec);
     const Vec2* pickWaypoint();
-    std::vector<Entity*> checkCollision();
+    FrameVector<Entity*> checkCollision();
+    bool isCollisionTick() const;
     void processCollision(Entity* otherMob, float deltaTSec, Vec2 moveVec);
 
 private:
     const Vec2* m_pWaypoint;
-    void moveAround(std::vector<Entity *> enemySpotted, Vec2 shelterPos, float shelterSize, float moveDist, bool hideGiant, float deltaTSec, Vec2 moveVec);
-    std::vector<Entity*> entityNoticeThisMob() const;
-    std::vector<Entity*> enemiesInSight() const;
-    std::vector<Entity*> seekEntityWithinRadius(float radius, bool side);
-    bool handleEdgeCollsion(Vec2 moveVec);
+    bool m_bSensedHidden;       // Rogues only: whether decide() found us hidden
+
+    // We go to sleep when decide() finds no enemies we could see and no 
+    // allies we could bump into, allowing MOB_SLEEP_MARGIN on top, and stay 
+    // asleep until we change cells or the EventGrid sees something happen 
+    // near us.
+    bool m_bAsleep;
+    int m_SleepCell;
+    uint64_t m_SleepEvents;
+    bool canSleep() const;
+    float getSleepRadius(bool bAllies) const;
+    uint64_t sumSleepEvents() const;
+    void walkPath(float deltaTSec);
+    void stepToward(Vec2& moveVec, float distRemaining, float moveDist);
+
+    void moveAround(const FrameVector<Entity *>& enemySpotted, Vec2 shelterPos, float shelterSize, float moveDist, bool hideGiant, float deltaTSec, Vec2 moveVec);
+    FrameVector<Entity*> entityNoticeThisMob() const;
+    FrameVector<Entity*> enemiesInSight() const;
+    FrameVector<Entity*> seekEntityWithinRadius(float radius, bool side);
+    bool resolveObstacles();
+    bool sweepTo(const Vec2& destPos);
+    void sweepMobs(const Vec2& startPos);
 };
@@ -0,0 +1,245 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ObstacleField.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+
+const float ObstacleField::kMaxDistance = 4.f;
+
+static const float kSampleSpacing = 1.f / (float)ObstacleField::kSamplesPerTile;
+
+// Closer than this to an obstacle counts as touching it, for sweep().  The 
+// smallest step it takes is half a sample, so that a long slide along a wall 
+// doesn't take forever.
+static const float kContactDistance = 0.01f;
+static const float kMinSweepStep = kSampleSpacing / 2.f;
+
+// The signed distance from pos to an axis aligned box: negative inside it
+static float boxDistance(const Vec2& pos, float minX, float minY, float maxX, float maxY)
+{
+    float halfW = (maxX - minX) * 0.5f;
+    float halfH = (maxY - minY) * 0.5f;
+    float dx = fabsf(pos.x - (minX + halfW)) - halfW;
+    float dy = fabsf(pos.y - (minY + halfH)) - halfH;
+
+    float outsideX = std::max(dx, 0.f);
+    float outsideY = std::max(dy, 0.f);
+    return sqrtf((outsideX * outsideX) + (outsideY * outsideY)) + std::min(std::max(dx, dy), 0.f);
+}
+
+ObstacleField::ObstacleField()
+    : m_Distance(kWidth * kHeight)
+    , m_GradientX(kWidth * kHeight)
+    , m_GradientY(kWidth * kHeight)
+{
+    clear();
+}
+
+void ObstacleField::clear()
+{
+    m_Towers.clear();
+    update(0, 0, kWidth - 1, kHeight - 1);
+}
+
+void ObstacleField::addTower(const Vec2& pos, float size)
+{
+    Tower tower = { pos, size / 2.f };
+    m_Towers.push_back(tower);
+    updateAround(pos, tower.m_Radius);
+}
+
+void ObstacleField::removeTower(const Vec2& pos)
+{
+    for (size_t i = 0; i < m_Towers.size(); ++i)
+    {
+        if (m_Towers[i].m_Pos == pos)
+        {
+            float radius = m_Towers[i].m_Radius;
+            m_Towers.erase(m_Towers.begin() + i);
+            updateAround(pos, radius);
+            return;
+        }
+    }
+
+    assert(false && "No tower there");
+}
+
+float ObstacleField::sample(const Vec2& pos, Vec2* pGradient) const
+{
+    // Clamp to the grid, then find the cell and how far across it we are
+    float gx = (pos.x + (float)kBorderTiles) * (float)kSamplesPerTile;
+    float gy = (pos.y + (float)kBorderTiles) * (float)kSamplesPerTile;
+    gx = std::min(std::max(gx, 0.f), (float)(kWidth - 1) - 0.001f);
+    gy = std::min(std::max(gy, 0.f), (float)(kHeight - 1) - 0.001f);
+
+    int x = (int)gx;
+    int y = (int)gy;
+    float fx = gx - (float)x;
+    float fy = gy - (float)y;
+
+    int i = (y * kWidth) + x;
+    float w00 = (1.f - fx) * (1.f - fy);
+    float w10 = fx * (1.f - fy);
+    float w01 = (1.f - fx) * fy;
+    float w11 = fx * fy;
+
+    if (pGradient)
+    {
+        pGradient->x = (m_GradientX[i] * w00) + (m_GradientX[i + 1] * w10) + 
+                       (m_GradientX[i + kWidth] * w01) + (m_GradientX[i + kWidth + 1] * w11);
+        pGradient->y = (m_GradientY[i] * w00) + (m_GradientY[i + 1] * w10) + 
+                       (m_GradientY[i + kWidth] * w01) + (m_GradientY[i + kWidth + 1] * w11);
+    }
+
+    return (m_Distance[i] * w00) + (m_Distance[i + 1] * w10) + 
+           (m_Distance[i + kWidth] * w01) + (m_Distance[i + kWidth + 1] * w11);
+}
+
+bool ObstacleField::resolve(Vec2& pos, float radius) const
+{
+    Vec2 gradient;
+    float distance = sample(pos, &gradient);
+    if (distance >= radius)
+        return false;
+
+    if (gradient.normalize() <= 0.f)
+        return false;
+
+    pos += gradient * (radius - distance);
+    return true;
+}
+
+bool ObstacleField::sweep(Vec2& pos, const Vec2& dest, float radius) const
+{
+    bool bBlocked = resolve(pos, radius);
+
+    Vec2 dir = dest - pos;
+    float distRemaining = dir.normalize();
+    while (distRemaining > 0.f)
+    {
+        Vec2 gradient;
+        float clearance = sample(pos, &gradient) - radius;
+        if (clearance <= kContactDistance)
+        {
+            // Touching something, so drop the part of the move that goes into
+            // it.  If that's all of it, we're stuck.
+            gradient.normalize();
+            float into = (dir.x * gradient.x) + (dir.y * gradient.y);
+            if (into < 0.f)
+            {
+                bBlocked = true;
+                dir -= gradient * into;
+                distRemaining *= dir.normalize();
+                if (distRemaining < kContactDistance)
+                    break;
+            }
+        }
+
+        // Nothing is closer than the clearance, so we can safely go that far
+        float step = std::min(std::max(clearance, kMinSweepStep), distRemaining);
+        pos += dir * step;
+        distRemaining -= step;
+
+        if (clearance < kMinSweepStep)
+        {
+            resolve(pos, radius);
+        }
+    }
+
+    return bBlocked;
+}
+
+void ObstacleField::updateAround(const Vec2& pos, float radius)
+{
+    // Samples further than kMaxDistance from the obstacle can't have changed,
+    // but the gradients one sample beyond that read the ones that did.
+    float reach = radius + kMaxDistance + kSampleSpacing;
+    int minX = (int)floorf((pos.x - reach + (float)kBorderTiles) * (float)kSamplesPerTile);
+    int minY = (int)floorf((pos.y - reach + (float)kBorderTiles) * (float)kSamplesPerTile);
+    int maxX = (int)ceilf((pos.x + reach + (float)kBorderTiles) * (float)kSamplesPerTile);
+    int maxY = (int)ceilf((pos.y + reach + (float)kBorderTiles) * (float)kSamplesPerTile);
+
+    update(std::max(minX, 0), std::max(minY, 0), std::min(maxX, kWidth - 1), std::min(maxY, kHeight - 1));
+}
+
+void ObstacleField::update(int minX, int minY, int maxX, int maxY)
+{
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            m_Distance[(y * kWidth) + x] = computeDistance(getSamplePos(x, y));
+        }
+    }
+
+    // Central differences, or one-sided ones at the edges of the grid.  These
+    // read one sample beyond the rectangle, which is why updateAround() pads it.
+    for (int y = minY; y <= maxY; ++y)
+    {
+        int y0 = std::max(y - 1, 0);
+        int y1 = std::min(y + 1, kHeight - 1);
+        for (int x = minX; x <= maxX; ++x)
+        {
+            int x0 = std::max(x - 1, 0);
+            int x1 = std::min(x + 1, kWidth - 1);
+
+            int i = (y * kWidth) + x;
+            m_GradientX[i] = (m_Distance[(y * kWidth) + x1] - m_Distance[(y * kWidth) + x0]) / ((float)(x1 - x0) * kSampleSpacing);
+            m_GradientY[i] = (m_Distance[(y1 * kWidth) + x] - m_Distance[(y0 * kWidth) + x]) / ((float)(y1 - y0) * kSampleSpacing);
+        }
+    }
+}
+
+float ObstacleField::computeDistance(const Vec2& pos) const
+{
+    // Inside the arena, the distance to its nearest edge.  Outside, how far 
+    // out we are (negated).
+    float distance = boxDistance(pos, 0.f, 0.f, (float)GAME_GRID_WIDTH, (float)GAME_GRID_HEIGHT);
+    distance = -distance;
+
+    // The river is three boxes: left of the left bridge, between the bridges,
+    // and right of the right bridge.  The outer two run off the arena, so 
+    // that the border doesn't have a gap in it.
+    const float border = (float)kBorderTiles;
+    const float leftBridgeMin = LEFT_BRIDGE_CENTER_X - (BRIDGE_WIDTH / 2.f);
+    const float leftBridgeMax = LEFT_BRIDGE_CENTER_X + (BRIDGE_WIDTH / 2.f);
+    const float rightBridgeMin = RIGHT_BRIDGE_CENTER_X - (BRIDGE_WIDTH / 2.f);
+    const float rightBridgeMax = RIGHT_BRIDGE_CENTER_X + (BRIDGE_WIDTH / 2.f);
+    distance = std::min(distance, boxDistance(pos, RIVER_LEFT_X - border, RIVER_TOP_Y, leftBridgeMin, RIVER_BOT_Y));
+    distance = std::min(distance, boxDistance(pos, leftBridgeMax, RIVER_TOP_Y, rightBridgeMin, RIVER_BOT_Y));
+    distance = std::min(distance, boxDistance(pos, rightBridgeMax, RIVER_TOP_Y, RIVER_RIGHT_X + border, RIVER_BOT_Y));
+
+    for (const Tower& tower : m_Towers)
+    {
+        distance = std::min(distance, pos.dist(tower.m_Pos) - tower.m_Radius);
+    }
+
+    return std::min(distance, kMaxDistance);
+}
+
+Vec2 ObstacleField::getSamplePos(int x, int y) const
+{
+    return Vec2(((float)x * kSampleSpacing) - (float)kBorderTiles, ((float)y * kSampleSpacing) - (float)kBorderTiles);
+}
@@ -0,0 +1,101 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Constants.h"
+#include "Vec2.h"
+
+#include <vector>
+
+// A signed distance field for everything that a mob can't walk through and
+// that doesn't move: the edges of the arena, the river (less the bridges),
+// and the towers.  It's sampled on a grid, with the gradient alongside, so 
+// keeping a mob out of all of them is one bilinear lookup and a push away 
+// from whatever is nearest.
+// NOTE: Towers are circles as wide as their size, which is how movement and
+// attack range already treat them.
+class ObstacleField
+{
+public:
+    static const int kSamplesPerTile = 4;
+
+    // The field reaches this far past the edges of the arena, so that a mob 
+    // that's been shoved off the edge is still pushed back on.
+    static const int kBorderTiles = 1;
+
+    static const int kWidth = ((GAME_GRID_WIDTH + (2 * kBorderTiles)) * kSamplesPerTile) + 1;
+    static const int kHeight = ((GAME_GRID_HEIGHT + (2 * kBorderTiles)) * kSamplesPerTile) + 1;
+
+    // Distances are clamped to this, which means a change to one obstacle 
+    // only touches the samples near it.
+    static const float kMaxDistance;
+
+    ObstacleField();
+
+    // Starts over with just the arena and the river
+    void clear();
+
+    void addTower(const Vec2& pos, float size);
+
+    // Call this when a tower falls, so that mobs can walk where it stood.
+    void removeTower(const Vec2& pos);
+
+    // The distance from pos to the nearest obstacle (negative if it's inside
+    // one), up to kMaxDistance.  If pGradient isn't NULL it gets the 
+    // direction away from the nearest obstacle, which is roughly unit length
+    // near one and zero once we're kMaxDistance away.
+    float sample(const Vec2& pos, Vec2* pGradient = NULL) const;
+
+    // Pushes a circle out of any obstacle it overlaps.  Returns true if it 
+    // had to move.
+    bool resolve(Vec2& pos, float radius) const;
+
+    // Moves a circle from pos toward dest without letting it pass through 
+    // anything on the way, however far that is.  It steps by the distance to
+    // the nearest obstacle, and slides along any that it runs into.  Returns
+    // true if it was blocked or deflected.
+    bool sweep(Vec2& pos, const Vec2& dest, float radius) const;
+
+private:
+    struct Tower
+    {
+        Vec2 m_Pos;
+        float m_Radius;
+    };
+
+    // Recomputes the samples (and their gradients) in a rectangle of the 
+    // grid, given in sample indices.
+    void update(int minX, int minY, int maxX, int maxY);
+    void updateAround(const Vec2& pos, float radius);
+
+    float computeDistance(const Vec2& pos) const;
+    Vec2 getSamplePos(int x, int y) const;
+
+private:
+    std::vector<Tower> m_Towers;
+
+    // kWidth * kHeight samples each, a row at a time
+    std::vector<float> m_Distance;
+    std::vector<float> m_GradientX;
+    std::vector<float> m_GradientY;
+};
@@ -0,0 +1,101 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "PerfOverlay.h"
+
+#include <algorithm>
+#include <assert.h>
+
+PerfHistory::PerfHistory()
+    : m_Next(0)
+    , m_Count(0)
+{
+    clear();
+}
+
+void PerfHistory::add(float ms)
+{
+    m_Samples[m_Next] = ms;
+    m_Next = (m_Next + 1) % kNumSamples;
+    m_Count = std::min(m_Count + 1, kNumSamples);
+}
+
+void PerfHistory::clear()
+{
+    std::fill(m_Samples, m_Samples + kNumSamples, 0.f);
+    m_Next = 0;
+    m_Count = 0;
+}
+
+float PerfHistory::getSample(size_t i) const
+{
+    assert(i < m_Count);
+    size_t oldest = (m_Next + kNumSamples - m_Count) % kNumSamples;
+    return m_Samples[(oldest + i) % kNumSamples];
+}
+
+float PerfHistory::getCurrent() const
+{
+    return (m_Count > 0) ? getSample(m_Count - 1) : 0.f;
+}
+
+float PerfHistory::getAverage() const
+{
+    if (m_Count == 0) { return 0.f; }
+
+    float total = 0.f;
+    for (size_t i = 0; i < m_Count; ++i)
+    {
+        total += m_Samples[i];
+    }
+    return total / (float)m_Count;
+}
+
+float PerfHistory::getMax() const
+{
+    float result = 0.f;
+    for (size_t i = 0; i < m_Count; ++i)
+    {
+        result = std::max(result, m_Samples[i]);
+    }
+    return result;
+}
+
+float PerfHistory::getPercentile(float fraction) const
+{
+    if (m_Count == 0) { return 0.f; }
+
+    // NOTE: The samples that are held are always the first m_Count entries of
+    // the array (we only wrap once it's full), so they can be copied as is.
+    float sorted[kNumSamples];
+    std::copy(m_Samples, m_Samples + m_Count, sorted);
+
+    size_t index = (size_t)(fraction * (float)(m_Count - 1) + 0.5f);
+    index = std::min(index, m_Count - 1);
+    std::nth_element(sorted, sorted + index, sorted + m_Count);
+    return sorted[index];
+}
+
+PerfOverlay::PerfOverlay()
+    : m_bVisible(false)
+{
+}
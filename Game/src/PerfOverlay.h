@@ -0,0 +1,77 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+
+// A fixed number of recent samples (in milliseconds), oldest overwritten first.
+class PerfHistory
+{
+public:
+    static const size_t kNumSamples = 120;
+
+    PerfHistory();
+
+    void add(float ms);
+    void clear();
+
+    size_t size() const { return m_Count; }
+
+    // i == 0 is the oldest sample still held
+    float getSample(size_t i) const;
+
+    float getCurrent() const;
+    float getAverage() const;
+    float getMax() const;
+
+    // fraction is in [0, 1], so 0.99 gives the 99th percentile
+    float getPercentile(float fraction) const;
+
+private:
+    float m_Samples[kNumSamples];
+    size_t m_Next;
+    size_t m_Count;
+};
+
+// The data behind the F3 performance overlay.  Graphics draws it in the UI
+// panel; the main loop feeds it one frame sample per frame drawn and one tick
+// sample per snapshot received.
+class PerfOverlay
+{
+public:
+    PerfOverlay();
+
+    void toggle() { m_bVisible = !m_bVisible; }
+    bool isVisible() const { return m_bVisible; }
+
+    void addFrameSample(float ms) { m_Frames.add(ms); }
+    void addTickSample(float ms) { m_Ticks.add(ms); }
+
+    const PerfHistory& getFrames() const { return m_Frames; }
+    const PerfHistory& getTicks() const { return m_Ticks; }
+
+private:
+    bool m_bVisible;
+    PerfHistory m_Frames;
+    PerfHistory m_Ticks;
+};
@@ -27,11 +27,20 @@
 #include "iController.h"
 #include "Game.h"
 #include "Mob.h"
+#include "Profiler.h"
+#include "SimStats.h"
+
+#include <chrono>
+#include <climits>
 
 Player::Player(iController* pControl, bool bNorth)
     : m_pControl(pControl)
     , m_bNorth(bNorth)
     , m_Elixir(capElixir(STARTING_ELIXIR))
+    , m_LastControllerMs(0.f)
+    , m_ControllerDeltaSec(0.f)
+    , m_bPackedDirty(true)
+    , m_bMobCellsDirty(true)
 {
     buildBuildings();
 
@@ -41,6 +50,12 @@ Player::Player(iController* pControl, bool bNorth)
         m_AvailableMobs.push_back((iEntityStats::MobType)i);
     }
 
+    // ...and so are all spell types.
+    for (size_t i = 0; i < iSpellStats::numSpellTypes; ++i)
+    {
+        m_AvailableSpells.push_back((iSpellStats::SpellType)i);
+    }
+
     if (m_pControl)
         m_pControl->setPlayer(*this);
 }
@@ -50,7 +65,6 @@ Player::~Player()
     delete m_pControl;      // it's safe to delete NULL
     for (Entity* pBuilding : m_Buildings) delete pBuilding;
     for (Entity* pMob : m_Mobs) delete pMob;
-    for (Entity* pMob : m_DeadMobs) delete pMob;
 }
 
 iPlayer::PlacementResult Player::placeMob(iEntityStats::MobType type, const Vec2& pos)
@@ -114,19 +128,91 @@ iPlayer::PlacementResult Player::placeMob(iEntityStats::MobType type, const Vec2
 
     // Checks are done - make the mob.
     m_Elixir -= cost;
-    Mob* pMob = new Mob(stats, tilePos, m_bNorth);
-    m_Mobs.push_back(pMob);
+    spawnMob(type, tilePos);
+
+    return Success;
+}
+
+iPlayer::PlacementResult Player::castSpell(iSpellStats::SpellType type, const Vec2& pos)
+{
+    // Anywhere in the arena will do
+    if ((pos.x < 0) || (pos.x > GAME_GRID_WIDTH))
+    {
+        std::cout << "Invalid Location (X): (" << pos.x << ", " <<
+            pos.y << ")\n";
+        return InvalidX;
+    }
+
+    if ((pos.y < 0) || (pos.y > GAME_GRID_HEIGHT))
+    {
+        std::cout << "Invalid Location (Y): (" << pos.x << ", " <<
+            pos.y << ")\n";
+        return InvalidY;
+    }
+
+    // Validate that we have enough elixir
+    const iSpellStats& stats = iSpellStats::getStats(type);
+    const float cost = stats.getElixirCost();
+    if (cost > m_Elixir)
+    {
+        std::cout << "Insufficient Elixir: " << cost << " > " << m_Elixir <<
+            std::endl;
+
+        return InsufficientElixir;
+    }
+
+    if (std::find(m_AvailableSpells.begin(), m_AvailableSpells.end(), type) == m_AvailableSpells.end())
+    {
+        std::cout << "Spell type not available\n";
+
+        return SpellTypeUnavailable;
+    }
+
+    // Checks are done - the spell lands at the end of this tick's apply phase
+    m_Elixir -= cost;
+    Game::get().getAreaEffects().cast(stats, m_bNorth, pos);
 
     return Success;
 }
 
+Entity* Player::spawnMob(iEntityStats::MobType type, const Vec2& pos)
+{
+    Mob* pMob = new Mob(iEntityStats::getStats(type), pos, m_bNorth);
+    Game::get().getRegistry().add(pMob);
+    pMob->onSpawned();
+    m_Mobs.push_back(pMob);
+    invalidatePackedPositions();
+
+    return pMob;
+}
+
 void Player::tick(float deltaTSec)
 {
+    PROFILE_SCOPE("Player::tick");
+
     m_Elixir += deltaTSec * ELIXIR_PER_SECOND;
     m_Elixir = std::min(m_Elixir, 10.f);
 
-    if (m_pControl)
-        m_pControl->tick(deltaTSec, Game::get().getMobs(m_bNorth), Game::get().getMobs(!m_bNorth));
+    // Over budget, the controllers take turns thinking, and each is told how
+    // long it's been since it last did.
+    Game& game = Game::get();
+    m_ControllerDeltaSec += deltaTSec;
+    bool bThink = !game.getTickBudget().isActive(TickBudget::ThrottleControllers) ||
+        (((game.getTickCount() + (m_bNorth ? 0 : 1)) & 1) == 0);
+
+    m_LastControllerMs = 0.f;
+    if (bThink)
+    {
+        if (m_pControl)
+        {
+            PROFILE_SCOPE("Controller::tick");
+            ScopedSimTimer timer(SimStats::Controller);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            m_pControl->tick(m_ControllerDeltaSec, game.getMobs(m_bNorth), game.getMobs(!m_bNorth));
+            m_LastControllerMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        m_ControllerDeltaSec = 0.f;
+    }
 
     for (Entity* pBuilding : m_Buildings) {
         if (!pBuilding->isDead()) {
@@ -140,7 +226,39 @@ void Player::tick(float deltaTSec)
         }
     }
 
-    // Move any mobs that died this tick into m_DeadMobs
+    // Everything we own may have moved.
+    invalidatePackedPositions();
+}
+
+int Player::getIdleTicks() const
+{
+    return m_pControl ? m_pControl->getIdleTicks() : INT_MAX;
+}
+
+void Player::skipTicks(int numTicks, float deltaTSec)
+{
+    // The same steps as tick(), rather than one multiply, so that the float 
+    // rounding (and so when we cross the controller's thresholds) comes out
+    // exactly as if we'd ticked.  Once we're full it stops changing.
+    for (int i = 0; i < numTicks; ++i)
+    {
+        m_Elixir += deltaTSec * ELIXIR_PER_SECOND;
+        m_Elixir = std::min(m_Elixir, 10.f);
+        if (m_Elixir >= 10.f)
+            break;
+    }
+
+    if (m_pControl)
+    {
+        m_pControl->skipTicks(numTicks);
+    }
+}
+
+void Player::freeDeadMobs()
+{
+    // Their slots in the registry are recycled, so any handles that still 
+    // point at them go stale.
+    EntityRegistry& registry = Game::get().getRegistry();
     size_t newIndex = 0;
     for (size_t oldIndex = 0; oldIndex < m_Mobs.size(); ++oldIndex)
     {
@@ -154,7 +272,8 @@ void Player::tick(float deltaTSec)
         }
         else
         {
-            m_DeadMobs.push_back(m_Mobs[oldIndex]);
+            registry.remove(pMob->getHandle());
+            delete pMob;
         }
     }
 
@@ -162,6 +281,54 @@ void Player::tick(float deltaTSec)
     m_Mobs.resize(newIndex);
 }
 
+const PackedPositions& Player::getPackedMobs() const
+{
+    updatePackedPositions();
+    return m_PackedMobs;
+}
+
+const PackedPositions& Player::getPackedBuildings() const
+{
+    updatePackedPositions();
+    return m_PackedBuildings;
+}
+
+void Player::findMobsWithin(const Vec2& pos, float radius, FrameVector<Entity*>& result) const
+{
+    updatePackedPositions();
+    if (m_bMobCellsDirty)
+    {
+        m_MobCells.build(m_PackedMobs);
+        m_bMobCellsDirty = false;
+    }
+
+    SimStats::get().count(SimStats::SpatialQueries);
+    SpatialKernels::findAllWithinCells(m_PackedMobs, m_MobCells, pos, radius, result);
+}
+
+void Player::updatePackedPositions() const
+{
+    if (!m_bPackedDirty)
+        return;
+
+    m_PackedMobs.clear();
+    for (Entity* pMob : m_Mobs)
+    {
+        if (!pMob->isDead())
+            m_PackedMobs.add(pMob);
+    }
+
+    m_PackedBuildings.clear();
+    for (Entity* pBuilding : m_Buildings)
+    {
+        if (!pBuilding->isDead())
+            m_PackedBuildings.add(pBuilding);
+    }
+
+    m_bPackedDirty = false;
+    m_bMobCellsDirty = true;
+}
+
 iPlayer::EntityData Player::getBuilding(unsigned int i) const
 {
     if (i < m_Buildings.size())
@@ -202,6 +369,17 @@ iPlayer::EntityData Player::getOpponentMob(unsigned int i) const
     return EntityData();
 }
 
+iPlayer::EntityData Player::getEntity(EntityHandle h) const
+{
+    const Entity* pEntity = Game::get().getRegistry().get(h);
+    if (pEntity)
+    {
+        return pEntity->getData();
+    }
+
+    return EntityData();
+}
+
 void Player::buildBuildings()
 {
     const iEntityStats& kingStats = iEntityStats::getBuildingStats(iEntityStats::King);
@@ -219,6 +397,13 @@ void Player::buildBuildings()
         m_Buildings.push_back(new Building(princessStats, Vec2(PrincessLeftX, SouthPrincessY), false));
         m_Buildings.push_back(new Building(princessStats, Vec2(PrincessRightX, SouthPrincessY), false));
     }
+
+    EntityRegistry& registry = Game::get().getRegistry();
+    for (Entity* pBuilding : m_Buildings)
+    {
+        registry.add(pBuilding);
+        pBuilding->onSpawned();
+    }
 }
 
 const Player& Player::GetOpponent() const
@@ -25,6 +25,7 @@
 #include "iPlayer.h"
 
 #include "Constants.h"
+#include "SpatialKernels.h"
 #include <algorithm>
 #include <assert.h>
 
@@ -42,12 +43,50 @@ public:
     virtual float getElixir() const { return (float)m_Elixir; }
     virtual const std::vector<iEntityStats::MobType>& GetAvailableMobTypes() const { return m_AvailableMobs; }
     virtual PlacementResult placeMob(iEntityStats::MobType type, const Vec2& pos);
+    virtual const std::vector<iSpellStats::SpellType>& GetAvailableSpellTypes() const { return m_AvailableSpells; }
+    virtual PlacementResult castSpell(iSpellStats::SpellType type, const Vec2& pos);
 
     void tick(float deltaTSec);
 
+    // For Game::skipQuietTicks().  We can skip as many ticks as our controller
+    // would sit idle for, and skipping them gains the same elixir as ticking.
+    int getIdleTicks() const;
+    void skipTicks(int numTicks, float deltaTSec);
+
+    // Frees the mobs that have died.  Game calls this once per tick, after the
+    // tick's damage has been resolved.
+    void freeDeadMobs();
+
+    // How long our controller took to think during the last tick
+    float getLastControllerMs() const { return m_LastControllerMs; }
+
+    // Creates a mob at exactly the given position, skipping every check that
+    // placeMob() does (elixir, side of the river, availability).  This is for 
+    // tools like the benchmarks and is deliberately not part of iPlayer, so
+    // controllers can't call it.
+    Entity* spawnMob(iEntityStats::MobType type, const Vec2& pos);
+
     const std::vector<Entity*>& getBuildings() const { return m_Buildings; }
     const std::vector<Entity*>& getMobs() const { return m_Mobs; }
 
+    // Our live mobs and buildings, packed for SpatialKernels.  They're rebuilt
+    // on demand after anything has invalidated them.
+    // NOTE: The positions are a copy, so they're only good while our entities
+    // aren't moving - in practice, during the decide phase and the opponent's
+    // tick.  Only use them to query the enemy side.  Rebuilding them isn't 
+    // thread safe, so Game::decide() makes sure that they're up to date 
+    // before the jobs start.
+    const PackedPositions& getPackedMobs() const;
+    const PackedPositions& getPackedBuildings() const;
+
+    // Our live mobs within radius of pos, found through PackedCells.  The 
+    // same caveats apply as for the packed positions, and the cells are only
+    // built the first time they're asked for after a repack.
+    void findMobsWithin(const Vec2& pos, float radius, FrameVector<Entity*>& result) const;
+
+    // Call this when one of our entities spawns, dies or moves.
+    void invalidatePackedPositions() { m_bPackedDirty = true; }
+
     virtual unsigned int getNumBuildings() const { return (unsigned int)m_Buildings.size(); }
     virtual EntityData getBuilding(unsigned int i) const;
 
@@ -60,11 +99,15 @@ public:
     virtual unsigned int getNumOpponentMobs() const { return GetOpponent().getNumMobs(); }
     virtual EntityData getOpponentMob(unsigned int i) const;
 
+    virtual EntityData getEntity(EntityHandle h) const;
+
 private:
     void buildBuildings();
 
     const Player& GetOpponent() const;
 
+    void updatePackedPositions() const;
+
     float capElixir(float e) const { return std::max(e, MAX_ELIXIR); }
 
 private:
@@ -72,14 +115,22 @@ private:
 
     bool m_bNorth;
     float m_Elixir;
+    float m_LastControllerMs;
+    float m_ControllerDeltaSec;             // game time since our controller last thought
 
     std::vector<iEntityStats::MobType> m_AvailableMobs;
+    std::vector<iSpellStats::SpellType> m_AvailableSpells;
 
     std::vector<Entity*> m_Buildings;       // owned
     std::vector<Entity*> m_Mobs;            // owned
 
-    // When mobs die, we move them to this vector.  For now we just hang on to 
-    // them forever - we never delete them - so as to avoid memory issues.
-    std::vector<Entity*> m_DeadMobs;        // owned
+    // Built lazily from the vectors above, hence mutable.
+    mutable PackedPositions m_PackedMobs;
+    mutable PackedPositions m_PackedBuildings;
+    mutable bool m_bPackedDirty;
+    mutable PackedCells m_MobCells;
+    mutable bool m_bMobCellsDirty;
 
+    // NOTE: Dead mobs are freed at the end of the tick.  Anything that needs to
+    // refer to an entity across ticks must hold its EntityHandle, not a pointer.
 };
@@ -0,0 +1,124 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Profiler.h"
+
+#include <stdio.h>
+
+Profiler* Singleton<Profiler>::s_Obj = NULL;
+
+namespace
+{
+    // NOTE: Owned by the profiler, not the thread, so that events recorded by
+    // a thread that has since exited still make it into the trace.
+    thread_local void* t_pThreadBuffer = NULL;
+}
+
+Profiler::Profiler()
+    : m_bEnabled(false)
+    , m_StartTime(Clock::now())
+{
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+    if (!t_pThreadBuffer)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        ThreadBuffer* pBuffer = new ThreadBuffer;
+        pBuffer->m_ThreadId = (uint32_t)m_Buffers.size() + 1;
+        pBuffer->m_NumDropped = 0;
+        m_Buffers.push_back(std::unique_ptr<ThreadBuffer>(pBuffer));
+
+        t_pThreadBuffer = pBuffer;
+    }
+
+    return *static_cast<ThreadBuffer*>(t_pThreadBuffer);
+}
+
+void Profiler::setThreadName(const char* name)
+{
+    getThreadBuffer().m_ThreadName = name;
+}
+
+void Profiler::record(const char* name, int64_t startNs, int64_t durationNs)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    if (buffer.m_Events.size() >= kMaxEventsPerThread)
+    {
+        ++buffer.m_NumDropped;
+        return;
+    }
+
+    Event e = { name, startNs, durationNs };
+    buffer.m_Events.push_back(e);
+}
+
+bool Profiler::writeChromeTrace(const char* path)
+{
+    FILE* pFile = fopen(path, "w");
+    if (!pFile)
+    {
+        printf("Couldn't open %s to write the profile.\n", path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Timestamps are in microseconds.  Events are written in the order they
+    // ended, which the trace viewers don't mind.
+    fprintf(pFile, "{\"traceEvents\": [\n");
+    bool bFirst = true;
+    size_t numEvents = 0;
+    size_t numDropped = 0;
+    for (const std::unique_ptr<ThreadBuffer>& pBuffer : m_Buffers)
+    {
+        if (!pBuffer->m_ThreadName.empty())
+        {
+            fprintf(pFile, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                bFirst ? "" : ",\n", pBuffer->m_ThreadId, pBuffer->m_ThreadName.c_str());
+            bFirst = false;
+        }
+
+        for (const Event& e : pBuffer->m_Events)
+        {
+            fprintf(pFile, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                bFirst ? "" : ",\n", e.m_Name, pBuffer->m_ThreadId, (double)e.m_StartNs / 1000.0, (double)e.m_DurationNs / 1000.0);
+            bFirst = false;
+        }
+
+        numEvents += pBuffer->m_Events.size();
+        numDropped += pBuffer->m_NumDropped;
+    }
+    fprintf(pFile, "\n], \"displayTimeUnit\": \"ms\"}\n");
+    fclose(pFile);
+
+    printf("Wrote %d profile events to %s", (int)numEvents, path);
+    if (numDropped > 0)
+    {
+        printf(" (%d more were dropped when the buffers filled up)", (int)numDropped);
+    }
+    printf("\n");
+
+    return true;
+}
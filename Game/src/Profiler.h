@@ -0,0 +1,134 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Singleton.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// A hierarchical scoped profiler that writes Chrome trace JSON (which can be
+// opened in chrome://tracing or ui.perfetto.dev).  Put PROFILE_SCOPE("name")
+// at the top of anything you want to see on the timeline; nested scopes show
+// up nested.
+//
+// PROFILE_SCOPE compiles to nothing unless CRASHLOYAL_PROFILER is defined, so
+// it's free to leave in the code.  When it is compiled in, recording still
+// has to be switched on with Profiler::get().setEnabled(true).
+//
+// Each thread records into a buffer of its own, so there's no locking on the
+// hot path.  Only call writeChromeTrace() once the other threads are done
+// recording (e.g. after they've been joined).
+#ifdef CRASHLOYAL_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+class Profiler : public Singleton<Profiler>
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Event
+    {
+        const char* m_Name;             // must be a string literal (or otherwise outlive the profiler)
+        int64_t m_StartNs;              // since the profiler was created
+        int64_t m_DurationNs;
+    };
+
+    Profiler();
+
+    static bool isCompiledIn()
+    {
+#ifdef CRASHLOYAL_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void setEnabled(bool bEnabled) { m_bEnabled = bEnabled; }
+    bool isEnabled() const { return m_bEnabled; }
+
+    // Names the calling thread on the timeline.
+    void setThreadName(const char* name);
+
+    int64_t now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_StartTime).count(); }
+
+    // Adds an event to the calling thread's buffer.
+    void record(const char* name, int64_t startNs, int64_t durationNs);
+
+    // Returns false if the file couldn't be written.
+    bool writeChromeTrace(const char* path);
+
+private:
+    struct ThreadBuffer
+    {
+        uint32_t m_ThreadId;
+        std::string m_ThreadName;
+        std::vector<Event> m_Events;
+        size_t m_NumDropped;
+    };
+
+    ThreadBuffer& getThreadBuffer();
+
+    // Stop recording on a thread once it has this many events, rather than
+    // eating all of the memory on a long run.
+    static const size_t kMaxEventsPerThread = 2000000;
+
+    bool m_bEnabled;
+    Clock::time_point m_StartTime;
+
+    std::mutex m_Mutex;             // guards m_Buffers (but not their contents)
+    std::vector<std::unique_ptr<ThreadBuffer> > m_Buffers;
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name)
+        : m_Name(name)
+        , m_StartNs(Profiler::get().isEnabled() ? Profiler::get().now() : -1)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (m_StartNs >= 0)
+        {
+            Profiler& profiler = Profiler::get();
+            profiler.record(m_Name, m_StartNs, profiler.now() - m_StartNs);
+        }
+    }
+
+private:
+    const char* m_Name;
+    int64_t m_StartNs;              // -1 if the profiler was off when we started
+};
@@ -0,0 +1,158 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ProjectilePool.h"
+
+#include "Constants.h"
+#include "DamageBuffer.h"
+#include "RenderSnapshot.h"
+
+#include <assert.h>
+
+#if !defined(CRASHLOYAL_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PROJECTILE_POOL_SSE
+#include <emmintrin.h>
+#endif
+#endif
+
+ProjectilePool::ProjectilePool()
+    : m_NumActive(0)
+    , m_X(MAX_PROJECTILES)
+    , m_Y(MAX_PROJECTILES)
+    , m_TimeLeft(MAX_PROJECTILES)
+    , m_VelX(MAX_PROJECTILES)
+    , m_VelY(MAX_PROJECTILES)
+    , m_Attacker(MAX_PROJECTILES)
+    , m_Target(MAX_PROJECTILES)
+    , m_Damage(MAX_PROJECTILES)
+    , m_bNorth(MAX_PROJECTILES)
+{
+}
+
+void ProjectilePool::clear()
+{
+    m_NumActive = 0;
+}
+
+bool ProjectilePool::fire(EntityHandle attacker, EntityHandle target, bool bNorth, const Vec2& from, const Vec2& to, int damage)
+{
+    if (m_NumActive >= MAX_PROJECTILES)
+        return false;
+
+    Vec2 dir = to - from;
+    float dist = dir.normalize();
+
+    int i = m_NumActive++;
+    m_X[i] = from.x;
+    m_Y[i] = from.y;
+    m_TimeLeft[i] = dist / PROJECTILE_SPEED;
+    m_VelX[i] = dir.x * PROJECTILE_SPEED;
+    m_VelY[i] = dir.y * PROJECTILE_SPEED;
+    m_Attacker[i] = attacker;
+    m_Target[i] = target;
+    m_Damage[i] = damage;
+    m_bNorth[i] = bNorth ? 1 : 0;
+    return true;
+}
+
+int ProjectilePool::update(float deltaTSec, DamageBuffer& damageBuffer)
+{
+    // One pass moves everything and counts the arrivals, so that most ticks
+    // never have to look through the pool a second time.
+    float* pX = m_X.data();
+    float* pY = m_Y.data();
+    float* pTimeLeft = m_TimeLeft.data();
+    const float* pVelX = m_VelX.data();
+    const float* pVelY = m_VelY.data();
+
+    int numArrived = 0;
+    int i = 0;
+#if defined(PROJECTILE_POOL_SSE)
+    const __m128 dt = _mm_set1_ps(deltaTSec);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= m_NumActive; i += 4)
+    {
+        _mm_storeu_ps(pX + i, _mm_add_ps(_mm_loadu_ps(pX + i), _mm_mul_ps(_mm_loadu_ps(pVelX + i), dt)));
+        _mm_storeu_ps(pY + i, _mm_add_ps(_mm_loadu_ps(pY + i), _mm_mul_ps(_mm_loadu_ps(pVelY + i), dt)));
+
+        __m128 timeLeft = _mm_sub_ps(_mm_loadu_ps(pTimeLeft + i), dt);
+        _mm_storeu_ps(pTimeLeft + i, timeLeft);
+
+        int arrived = _mm_movemask_ps(_mm_cmple_ps(timeLeft, zero));
+        numArrived += (arrived & 1) + ((arrived >> 1) & 1) + ((arrived >> 2) & 1) + ((arrived >> 3) & 1);
+    }
+#endif
+    for (; i < m_NumActive; ++i)
+    {
+        pX[i] += pVelX[i] * deltaTSec;
+        pY[i] += pVelY[i] * deltaTSec;
+        pTimeLeft[i] -= deltaTSec;
+        if (pTimeLeft[i] <= 0.f)
+            ++numArrived;
+    }
+
+    // The ones that have arrived land in the order they're found.  The damage
+    // just adds up, so that order doesn't matter.
+    int numLeft = numArrived;
+    for (i = 0; (numLeft > 0) && (i < m_NumActive); )
+    {
+        if (m_TimeLeft[i] <= 0.f)
+        {
+            damageBuffer.add(m_Attacker[i], m_Target[i], m_Damage[i]);
+            remove(i);
+            --numLeft;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    assert(numLeft == 0);
+
+    return numArrived;
+}
+
+void ProjectilePool::addToSnapshot(RenderSnapshot& snapshot) const
+{
+    for (int i = 0; i < m_NumActive; ++i)
+    {
+        RenderProjectile p = { Vec2(m_X[i], m_Y[i]), m_bNorth[i] != 0 };
+        snapshot.m_Projectiles.push_back(p);
+    }
+}
+
+void ProjectilePool::remove(int i)
+{
+    assert((i >= 0) && (i < m_NumActive));
+
+    int last = --m_NumActive;
+    m_X[i] = m_X[last];
+    m_Y[i] = m_Y[last];
+    m_TimeLeft[i] = m_TimeLeft[last];
+    m_VelX[i] = m_VelX[last];
+    m_VelY[i] = m_VelY[last];
+    m_Attacker[i] = m_Attacker[last];
+    m_Target[i] = m_Target[last];
+    m_Damage[i] = m_Damage[last];
+    m_bNorth[i] = m_bNorth[last];
+}
@@ -0,0 +1,89 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EntityHandle.h"
+#include "Vec2.h"
+
+#include <stdint.h>
+#include <vector>
+
+class DamageBuffer;
+struct RenderSnapshot;
+
+// The shots from Ranged attacks (Archers and towers) that haven't landed yet.
+// Each one flies in a straight line from where it was fired to where its 
+// target was at the time, at PROJECTILE_SPEED, and when it gets there its 
+// damage goes into the DamageBuffer like a melee attack would.  Like an arrow 
+// in the real game it can't miss, but if the target has died on the way the 
+// damage is simply dropped.
+//
+// The projectiles are stored as separate arrays, packed so that the ones in 
+// flight are always the first size() of each.  The arrays are allocated once,
+// at MAX_PROJECTILES each, so firing never allocates.
+// NOTE: Not thread safe.  Shots are fired in the apply phase.
+class ProjectilePool
+{
+public:
+    ProjectilePool();
+
+    void clear();
+
+    // Returns false if the pool is full, in which case nothing was fired and
+    // the caller should apply the damage right away.
+    bool fire(EntityHandle attacker, EntityHandle target, bool bNorth, const Vec2& from, const Vec2& to, int damage);
+
+    // Moves everything along by deltaTSec, then hands whatever has arrived to
+    // the damage buffer and drops it from the pool.  Returns how many landed.
+    int update(float deltaTSec, DamageBuffer& damageBuffer);
+
+    int size() const { return m_NumActive; }
+    bool empty() const { return m_NumActive == 0; }
+
+    void addToSnapshot(RenderSnapshot& snapshot) const;
+
+private:
+    // Moves the last projectile into slot i
+    void remove(int i);
+
+private:
+    int m_NumActive;
+
+    // Updated every tick
+    std::vector<float> m_X;
+    std::vector<float> m_Y;
+    std::vector<float> m_TimeLeft;
+
+    // Set when fired
+    std::vector<float> m_VelX;
+    std::vector<float> m_VelY;
+    std::vector<EntityHandle> m_Attacker;
+    std::vector<EntityHandle> m_Target;
+    std::vector<int> m_Damage;
+    std::vector<uint8_t> m_bNorth;
+
+private:
+    // DELIBERATELY UNDEFINED
+    ProjectilePool(const ProjectilePool& rhs);
+    ProjectilePool& operator=(const ProjectilePool& rhs);
+};
@@ -0,0 +1,53 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RenderSnapshot.h"
+
+#include <algorithm>
+
+SnapshotBuffer::SnapshotBuffer()
+    : m_WriteIndex(0)
+    , m_ReadyIndex(1)
+    , m_ReadIndex(2)
+    , m_bReadyIsNew(false)
+{
+}
+
+void SnapshotBuffer::publish()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::swap(m_WriteIndex, m_ReadyIndex);
+    m_bReadyIsNew = true;
+}
+
+const RenderSnapshot* SnapshotBuffer::acquireLatest()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_bReadyIsNew)
+    {
+        return NULL;
+    }
+
+    std::swap(m_ReadIndex, m_ReadyIndex);
+    m_bReadyIsNew = false;
+    return &m_Buffers[m_ReadIndex];
+}
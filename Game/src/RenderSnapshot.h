@@ -0,0 +1,124 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "SimStats.h"
+#include "SpellStats.h"
+#include "Vec2.h"
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+// Everything the renderer needs to know about one entity, copied out of the
+// simulation so that drawing never has to call back into live entities.
+struct RenderEntity
+{
+    Vec2 m_Pos;
+    float m_Size;
+    const char* m_DisplayLetter;    // points at static stats data
+    int m_Health;
+    int m_MaxHealth;
+    bool m_bNorth;
+    bool m_bDead;
+    bool m_bHidden;
+    bool m_bInvisible;
+};
+
+// A shot from a Ranged attack that hasn't landed yet
+struct RenderProjectile
+{
+    Vec2 m_Pos;
+    bool m_bNorth;      // who fired it
+};
+
+// A spell that's still having an effect
+struct RenderAreaEffect
+{
+    Vec2 m_Pos;
+    float m_Radius;
+    iSpellStats::SpellType m_Type;
+    bool m_bNorth;      // who cast it
+};
+
+// An immutable (once published) picture of the game after one tick.
+struct RenderSnapshot
+{
+    RenderSnapshot() : m_Tick(0), m_NorthElixir(0.f), m_SouthElixir(0.f), m_GameOverState(0) {}
+
+    // Empties the vectors without giving back their memory, so that a 
+    // snapshot that gets reused every tick doesn't keep reallocating.
+    void clear()
+    {
+        m_Buildings.clear();
+        m_Mobs.clear();
+        m_Projectiles.clear();
+        m_AreaEffects.clear();
+    }
+
+    uint64_t m_Tick;
+    std::vector<RenderEntity> m_Buildings;
+    std::vector<RenderEntity> m_Mobs;
+    std::vector<RenderProjectile> m_Projectiles;
+    std::vector<RenderAreaEffect> m_AreaEffects;
+    float m_NorthElixir;
+    float m_SouthElixir;
+    int m_GameOverState;
+    SimTickStats m_Stats;           // for the tick that produced this snapshot
+};
+
+// Triple buffer for handing snapshots from the simulation thread to the 
+// renderer.  The writer always has a buffer of its own to fill, the reader
+// always has one of its own to draw, and the third holds the newest published
+// snapshot.  Neither side ever waits on the other for longer than a swap.
+class SnapshotBuffer
+{
+public:
+    SnapshotBuffer();
+
+    // Writer: returns the buffer to fill for the next snapshot.
+    RenderSnapshot& beginWrite() { return m_Buffers[m_WriteIndex]; }
+
+    // Writer: makes the buffer from beginWrite() the newest snapshot.
+    void publish();
+
+    // Reader: if a newer snapshot has been published since the last call, takes
+    // it and returns it.  Otherwise returns NULL.
+    const RenderSnapshot* acquireLatest();
+
+    // Reader: the snapshot most recently returned by acquireLatest().
+    const RenderSnapshot& getCurrent() const { return m_Buffers[m_ReadIndex]; }
+
+private:
+    RenderSnapshot m_Buffers[3];
+    int m_WriteIndex;
+    int m_ReadyIndex;
+    int m_ReadIndex;
+    bool m_bReadyIsNew;
+
+    std::mutex m_Mutex;
+
+private:
+    // DELIBERATELY UNDEFINED
+    SnapshotBuffer(const SnapshotBuffer& rhs);
+    SnapshotBuffer& operator=(const SnapshotBuffer& rhs);
+};
@@ -0,0 +1,224 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Sandbox.h"
+
+#include "Constants.h"
+#include "Game.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+namespace
+{
+    bool equalsIgnoreCase(const std::string& a, const char* b)
+    {
+        if (a.size() != strlen(b))
+            return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (tolower(a[i]) != tolower(b[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // Every position is worked out for the North side and then mirrored, so
+    // that both sides get the same layout.
+    Vec2 toSide(const Vec2& northPos, bool bNorth)
+    {
+        return bNorth ? northPos : Vec2(northPos.x, (float)GAME_GRID_HEIGHT - northPos.y);
+    }
+
+    Vec2 randomPos(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> xDist(0.5f, (float)GAME_GRID_WIDTH - 0.5f);
+        std::uniform_real_distribution<float> yDist(0.5f, RIVER_TOP_Y - 0.5f);
+        float x = xDist(rng);
+        return Vec2(x, yDist(rng));
+    }
+
+    // Alternates between the lanes, filling ranks that start at the river and
+    // work back toward the king tower.
+    Vec2 lanePos(int i)
+    {
+        const int kUnitsPerRank = 4;
+        const float kSpacing = 0.5f;
+
+        int lane = i % 2;
+        int indexInLane = i / 2;
+        int rank = indexInLane / kUnitsPerRank;
+        int file = indexInLane % kUnitsPerRank;
+
+        float laneX = (lane == 0) ? LEFT_BRIDGE_CENTER_X : RIGHT_BRIDGE_CENTER_X;
+        float x = laneX + ((float)file - (float)(kUnitsPerRank - 1) / 2.f) * kSpacing;
+
+        // Wrap around once the ranks reach the back of the board
+        const int kNumRanks = (int)((RIVER_TOP_Y - 1.f) / kSpacing);
+        float y = RIVER_TOP_Y - 0.5f - (float)(rank % kNumRanks) * kSpacing;
+
+        return Vec2(x, y);
+    }
+
+    Vec2 gridPos(int i, int numUnits)
+    {
+        // Pick the number of columns so that the cells come out roughly square
+        const float width = (float)GAME_GRID_WIDTH - 1.f;
+        const float height = RIVER_TOP_Y - 1.f;
+        int numCols = std::max(1, (int)(sqrtf((float)numUnits * width / height) + 0.5f));
+        int numRows = (numUnits + numCols - 1) / numCols;
+
+        int col = i % numCols;
+        int row = i / numCols;
+        return Vec2(0.5f + width * ((float)col + 0.5f) / (float)numCols,
+                    0.5f + height * ((float)row + 0.5f) / (float)numRows);
+    }
+}
+
+SandboxOptions::SandboxOptions()
+    : m_NumUnitsPerSide(0)
+    , m_Pattern(Random)
+    , m_bNorth(true)
+    , m_bSouth(true)
+    , m_Seed(12345)
+{
+}
+
+bool Sandbox::parseTypes(const char* text, std::vector<iEntityStats::MobType>& types)
+{
+    types.clear();
+
+    std::string list(text);
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos)
+            end = list.size();
+
+        std::string name = list.substr(start, end - start);
+        bool bFound = false;
+        for (int t = 0; t < iEntityStats::numMobTypes; ++t)
+        {
+            if (equalsIgnoreCase(name, iEntityStats::getStats((iEntityStats::MobType)t).getName()))
+            {
+                types.push_back((iEntityStats::MobType)t);
+                bFound = true;
+                break;
+            }
+        }
+
+        if (!bFound)
+        {
+            printf("Unknown mob type: %s\n", name.c_str());
+            return false;
+        }
+
+        start = end + 1;
+    }
+
+    return !types.empty();
+}
+
+bool Sandbox::parsePattern(const char* text, SandboxOptions::Pattern& pattern)
+{
+    std::string name(text);
+    if (equalsIgnoreCase(name, "random"))
+        pattern = SandboxOptions::Random;
+    else if (equalsIgnoreCase(name, "lanes"))
+        pattern = SandboxOptions::Lanes;
+    else if (equalsIgnoreCase(name, "grid"))
+        pattern = SandboxOptions::Grid;
+    else
+    {
+        printf("Unknown spawn pattern: %s\n", text);
+        return false;
+    }
+
+    return true;
+}
+
+bool Sandbox::parseSides(const char* text, SandboxOptions& options)
+{
+    std::string name(text);
+    options.m_bNorth = equalsIgnoreCase(name, "north") || equalsIgnoreCase(name, "both");
+    options.m_bSouth = equalsIgnoreCase(name, "south") || equalsIgnoreCase(name, "both");
+
+    if (!options.m_bNorth && !options.m_bSouth)
+    {
+        printf("Unknown side: %s\n", text);
+        return false;
+    }
+
+    return true;
+}
+
+void Sandbox::spawn(const SandboxOptions& options)
+{
+    std::vector<iEntityStats::MobType> types = options.m_Types;
+    if (types.empty())
+    {
+        for (int t = 0; t < iEntityStats::numMobTypes; ++t)
+            types.push_back((iEntityStats::MobType)t);
+    }
+
+    std::mt19937 rng(options.m_Seed);
+    std::uniform_int_distribution<int> typeDist(0, (int)types.size() - 1);
+
+    for (bool bNorth : { true, false })
+    {
+        if ((bNorth && !options.m_bNorth) || (!bNorth && !options.m_bSouth))
+            continue;
+
+        Player& player = Game::get().getPlayer(bNorth);
+        for (int i = 0; i < options.m_NumUnitsPerSide; ++i)
+        {
+            Vec2 northPos;
+            iEntityStats::MobType type = types[i % types.size()];
+
+            switch (options.m_Pattern)
+            {
+            case SandboxOptions::Random:
+                northPos = randomPos(rng);
+                type = types[typeDist(rng)];
+                break;
+            case SandboxOptions::Lanes:
+                northPos = lanePos(i);
+                break;
+            case SandboxOptions::Grid:
+                northPos = gridPos(i, options.m_NumUnitsPerSide);
+                break;
+            }
+
+            player.spawnMob(type, toSide(northPos, bNorth));
+        }
+    }
+
+    printf("Sandbox: spawned %d units per side.\n", options.m_NumUnitsPerSide);
+}
@@ -0,0 +1,62 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EntityStats.h"
+
+#include <vector>
+
+// The sandbox fills the board with far more units than the economy would ever
+// allow, so that we can see how the simulation and renderer scale.  Units are
+// spawned with Player::spawnMob(), which skips the elixir and placement rules.
+struct SandboxOptions
+{
+    enum Pattern
+    {
+        Random,     // scattered over each side's half
+        Lanes,      // in ranks behind the two bridges
+        Grid,       // evenly spaced over each side's half
+    };
+
+    SandboxOptions();
+
+    int m_NumUnitsPerSide;
+    std::vector<iEntityStats::MobType> m_Types;     // used in turn (or picked at random, for Random)
+    Pattern m_Pattern;
+    bool m_bNorth;
+    bool m_bSouth;
+    unsigned int m_Seed;
+};
+
+class Sandbox
+{
+public:
+    // Parse the command line forms of the options.  Types are a comma
+    // separated list of mob names (case doesn't matter), e.g. "giant,archer".
+    static bool parseTypes(const char* text, std::vector<iEntityStats::MobType>& types);
+    static bool parsePattern(const char* text, SandboxOptions::Pattern& pattern);
+    static bool parseSides(const char* text, SandboxOptions& options);
+
+    // Spawns the units into the current match.
+    static void spawn(const SandboxOptions& options);
+};
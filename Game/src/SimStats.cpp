@@ -0,0 +1,78 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SimStats.h"
+
+SimStats* Singleton<SimStats>::s_Obj = NULL;
+
+SimStats::SimStats()
+    : m_bEnabled(false)
+{
+    reset();
+}
+
+const char* SimStats::getPhaseName(Phase phase)
+{
+    // NOTE: This must be kept in synch with the Phase enum
+    static const char* sNames[NumPhases] =
+    {
+        "tick",
+        "pick_target",
+        "move",
+        "collision",
+        "is_hidden",
+        "controller",
+        "decide",
+    };
+
+    assert((phase >= 0) && (phase < NumPhases));
+    return sNames[phase];
+}
+
+const char* SimStats::getCounterName(Counter counter)
+{
+    // NOTE: This must be kept in synch with the Counter enum
+    static const char* sNames[NumCounters] =
+    {
+        "spatial_queries",
+        "collision_pairs",
+        "sleeping_mob_ticks",
+        "projectiles_fired",
+    };
+
+    assert((counter >= 0) && (counter < NumCounters));
+    return sNames[counter];
+}
+
+void SimStats::reset()
+{
+    for (int i = 0; i < NumPhases; ++i)
+    {
+        m_TotalNs[i] = 0;
+        m_NumCalls[i] = 0;
+    }
+
+    for (int i = 0; i < NumCounters; ++i)
+    {
+        m_Counts[i] = 0;
+    }
+}
@@ -0,0 +1,160 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "AllocTracker.h"
+#include "Singleton.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+// Accumulates how long the simulation spends in each of its expensive phases.
+// It's off by default, in which case timing a phase costs a single branch.
+// It also counts a few things (like spatial queries) that are cheap enough
+// to count all the time.
+// NOTE: Phases nest - Tick includes everything else, and Move includes the
+// Collision work done by mobs that moved.  Decide is timed on the simulation
+// thread, but the PickTarget and IsHidden work inside it is spread across the
+// job system's threads and summed over all of them, so it can add up to more
+// than Decide itself.
+// Samples and counts may be added from any thread.
+class SimStats : public Singleton<SimStats>
+{
+public:
+    enum Phase
+    {
+        Tick,
+        PickTarget,
+        Move,
+        Collision,
+        IsHidden,
+        Controller,
+        Decide,
+
+        NumPhases
+    };
+
+    enum Counter
+    {
+        SpatialQueries,         // any search of the other entities for ones nearby
+        CollisionPairs,         // overlapping pairs found by collision checks
+        SleepingMobTicks,       // mob ticks that just walked, with nothing nearby to sense
+        ProjectilesFired,       // Ranged attacks that went into the ProjectilePool
+
+        NumCounters
+    };
+
+    SimStats();
+
+    static const char* getPhaseName(Phase phase);
+    static const char* getCounterName(Counter counter);
+
+    void setEnabled(bool bEnabled) { m_bEnabled = bEnabled; }
+    bool isEnabled() const { return m_bEnabled; }
+
+    // Zeroes every phase and counter.
+    void reset();
+
+    void addSample(Phase phase, uint64_t nanoseconds)
+    {
+        m_TotalNs[phase].fetch_add(nanoseconds, std::memory_order_relaxed);
+        m_NumCalls[phase].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t getTotalNs(Phase phase) const { return m_TotalNs[phase]; }
+    uint64_t getNumCalls(Phase phase) const { return m_NumCalls[phase]; }
+
+    // Counting is always on, whether or not timing is enabled.
+    void count(Counter counter, uint64_t amount = 1) { m_Counts[counter].fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t getCount(Counter counter) const { return m_Counts[counter]; }
+
+private:
+    bool m_bEnabled;
+    std::atomic<uint64_t> m_TotalNs[NumPhases];
+    std::atomic<uint64_t> m_NumCalls[NumPhases];
+    std::atomic<uint64_t> m_Counts[NumCounters];
+};
+
+// What happened during a single tick.  Game fills one in every tick (timing
+// the tick doesn't depend on SimStats being enabled) and it's handed to the
+// renderer with each snapshot, for the performance overlay.
+struct SimTickStats
+{
+    SimTickStats()
+        : m_TickMs(0.f)
+        , m_SpatialQueries(0)
+        , m_CollisionPairs(0)
+        , m_Allocations(-1)
+        , m_FallbackLevel(0)
+    {
+        m_ControllerMs[0] = m_ControllerMs[1] = 0.f;
+    }
+
+    float m_TickMs;
+    float m_ControllerMs[2];        // North, then South
+    uint64_t m_SpatialQueries;
+    uint64_t m_CollisionPairs;
+    int64_t m_Allocations;          // -1 unless AllocTracker is compiled in
+    int m_FallbackLevel;            // how many TickBudget fallbacks were on
+};
+
+// Times the enclosing scope and adds it to a phase in SimStats.  When 
+// allocation tracking is compiled in, it also charges anything allocated in
+// the scope to the phase.
+class ScopedSimTimer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit ScopedSimTimer(SimStats::Phase phase)
+        : m_Phase(phase)
+        , m_bActive(SimStats::get().isEnabled())
+#ifdef CRASHLOYAL_ALLOC_TRACKING
+        , m_PrevAllocPhase(AllocTracker::enterPhase(phase))
+#endif
+    {
+        if (m_bActive)
+            m_Start = Clock::now();
+    }
+
+    ~ScopedSimTimer()
+    {
+        if (m_bActive)
+        {
+            Clock::duration elapsed = Clock::now() - m_Start;
+            SimStats::get().addSample(m_Phase, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+#ifdef CRASHLOYAL_ALLOC_TRACKING
+        AllocTracker::leavePhase(m_PrevAllocPhase);
+#endif
+    }
+
+private:
+    SimStats::Phase m_Phase;
+    bool m_bActive;
+#ifdef CRASHLOYAL_ALLOC_TRACKING
+    int m_PrevAllocPhase;
+#endif
+    Clock::time_point m_Start;
+};
@@ -0,0 +1,438 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SpatialKernels.h"
+
+#include "Entity.h"
+#include "EntityStats.h"
+#include "EventGrid.h"
+
+#include <assert.h>
+
+#if !defined(CRASHLOYAL_NO_SIMD)
+#if defined(__AVX__)
+#define SPATIAL_KERNELS_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SPATIAL_KERNELS_SSE
+#include <emmintrin.h>
+#endif
+#endif
+
+void PackedPositions::clear()
+{
+    m_X.clear();
+    m_Y.clear();
+    m_HalfSize.clear();
+    m_Entities.clear();
+}
+
+void PackedPositions::add(Entity* pEntity)
+{
+    assert(pEntity);
+    const Vec2& pos = pEntity->getPosition();
+    m_X.push_back(pos.x);
+    m_Y.push_back(pos.y);
+    m_HalfSize.push_back(pEntity->getStats().getSize() / 2.f);
+    m_Entities.push_back(pEntity);
+}
+
+void PackedCells::build(const PackedPositions& packed)
+{
+    // A counting sort: count each cell's entries, turn the counts into
+    // starting points, then drop the entries into place.
+    const size_t numCells = EventGrid::kWidth * EventGrid::kHeight;
+    m_CellStart.assign(numCells + 1, 0);
+    m_Indices.resize(packed.size());
+
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        ++m_CellStart[EventGrid::getCell(Vec2(packed.m_X[i], packed.m_Y[i])) + 1];
+    }
+    for (size_t cell = 0; cell < numCells; ++cell)
+    {
+        m_CellStart[cell + 1] += m_CellStart[cell];
+    }
+
+    // Borrows the end of each cell's run as its write cursor, then puts it back
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        int cell = EventGrid::getCell(Vec2(packed.m_X[i], packed.m_Y[i]));
+        m_Indices[m_CellStart[cell]++] = (uint32_t)i;
+    }
+    for (size_t cell = numCells; cell > 0; --cell)
+    {
+        m_CellStart[cell] = m_CellStart[cell - 1];
+    }
+    m_CellStart[0] = 0;
+}
+
+// NOTE: All of the kernels compute (x[i] - pos.x)^2 + (y[i] - pos.y)^2 in
+// that order, which is what Vec2::distSqr() does, so that the SIMD and scalar
+// versions agree to the last bit with each other and with the code they 
+// replaced.  Don't "simplify" them into a fused multiply-add.
+
+const char* SpatialKernels::getInstructionSet()
+{
+#if defined(SPATIAL_KERNELS_AVX)
+    return "avx";
+#elif defined(SPATIAL_KERNELS_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Scalar versions
+
+static int findNearestFrom(const PackedPositions& packed, const Vec2& pos, size_t first, int best, float& bestDistSq)
+{
+    for (size_t i = first; i < packed.size(); ++i)
+    {
+        const float dx = packed.m_X[i] - pos.x;
+        const float dy = packed.m_Y[i] - pos.y;
+        const float distSq = dx * dx + dy * dy;
+        if (distSq < bestDistSq)
+        {
+            bestDistSq = distSq;
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+static void findAllFrom(const PackedPositions& packed, const Vec2& pos, float radiusSq, size_t first, FrameVector<Entity*>& result)
+{
+    for (size_t i = first; i < packed.size(); ++i)
+    {
+        const float dx = packed.m_X[i] - pos.x;
+        const float dy = packed.m_Y[i] - pos.y;
+        if (dx * dx + dy * dy < radiusSq)
+        {
+            result.push_back(packed.m_Entities[i]);
+        }
+    }
+}
+
+static bool anyWithinReachFrom(const PackedPositions& packed, const Vec2& pos, float reach, size_t first)
+{
+    for (size_t i = first; i < packed.size(); ++i)
+    {
+        const float dx = packed.m_X[i] - pos.x;
+        const float dy = packed.m_Y[i] - pos.y;
+        const float r = reach + packed.m_HalfSize[i];
+        if (dx * dx + dy * dy <= r * r)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int SpatialKernels::findNearestWithinScalar(const PackedPositions& packed, const Vec2& pos, float maxDistSq, float* pDistSq)
+{
+    float bestDistSq = maxDistSq;
+    int best = findNearestFrom(packed, pos, 0, -1, bestDistSq);
+    if (pDistSq && (best >= 0))
+        *pDistSq = bestDistSq;
+    return best;
+}
+
+void SpatialKernels::findAllWithinScalar(const PackedPositions& packed, const Vec2& pos, float radius, FrameVector<Entity*>& result)
+{
+    findAllFrom(packed, pos, radius * radius, 0, result);
+}
+
+bool SpatialKernels::anyWithinReachScalar(const PackedPositions& packed, const Vec2& pos, float reach)
+{
+    return anyWithinReachFrom(packed, pos, reach, 0);
+}
+
+void SpatialKernels::findAllWithinCells(const PackedPositions& packed, const PackedCells& cells, const Vec2& pos, float radius, FrameVector<Entity*>& result)
+{
+    assert(cells.m_Indices.size() == packed.size());
+
+    // getCell() clamps, so entities off the edge of the arena are in the edge
+    // cells, and so is the box we search.
+    const int minCell = EventGrid::getCell(Vec2(pos.x - radius, pos.y - radius));
+    const int maxCell = EventGrid::getCell(Vec2(pos.x + radius, pos.y + radius));
+    const int minX = minCell % EventGrid::kWidth;
+    const int maxX = maxCell % EventGrid::kWidth;
+    const int minY = minCell / EventGrid::kWidth;
+    const int maxY = maxCell / EventGrid::kWidth;
+
+    const float radiusSq = radius * radius;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        const uint32_t begin = cells.m_CellStart[(y * EventGrid::kWidth) + minX];
+        const uint32_t end = cells.m_CellStart[(y * EventGrid::kWidth) + maxX + 1];
+        for (uint32_t j = begin; j < end; ++j)
+        {
+            const uint32_t i = cells.m_Indices[j];
+            const float dx = packed.m_X[i] - pos.x;
+            const float dy = packed.m_Y[i] - pos.y;
+            if (dx * dx + dy * dy < radiusSq)
+            {
+                result.push_back(packed.m_Entities[i]);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// SIMD versions
+//
+// The lane indices are carried as floats, which is exact for anything under
+// 2^24 entities and keeps the AVX path free of 256-bit integer instructions
+// (those need AVX2).  Each lane keeps its own best, and the lanes are reduced
+// at the end by taking the smallest distance and then the smallest index, 
+// which gives the same answer as walking the entities in order.
+
+#if defined(SPATIAL_KERNELS_AVX)
+
+namespace
+{
+    const size_t kWidth = 8;
+
+    inline __m256 distSq8(const PackedPositions& packed, size_t i, __m256 px, __m256 py)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&packed.m_X[i]), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&packed.m_Y[i]), py);
+        return _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    }
+}
+
+int SpatialKernels::findNearestWithin(const PackedPositions& packed, const Vec2& pos, float maxDistSq, float* pDistSq)
+{
+    const size_t n = packed.size();
+    const size_t nSimd = n - (n % kWidth);
+
+    __m256 px = _mm256_set1_ps(pos.x);
+    __m256 py = _mm256_set1_ps(pos.y);
+    __m256 bestDist = _mm256_set1_ps(maxDistSq);
+    __m256 bestIndex = _mm256_set1_ps(-1.f);
+    __m256 index = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+    const __m256 step = _mm256_set1_ps((float)kWidth);
+
+    for (size_t i = 0; i < nSimd; i += kWidth)
+    {
+        __m256 d = distSq8(packed, i, px, py);
+        __m256 closer = _mm256_cmp_ps(d, bestDist, _CMP_LT_OQ);
+        bestDist = _mm256_blendv_ps(bestDist, d, closer);
+        bestIndex = _mm256_blendv_ps(bestIndex, index, closer);
+        index = _mm256_add_ps(index, step);
+    }
+
+    float dists[kWidth];
+    float indices[kWidth];
+    _mm256_storeu_ps(dists, bestDist);
+    _mm256_storeu_ps(indices, bestIndex);
+
+    float bestDistSq = maxDistSq;
+    int best = -1;
+    for (size_t lane = 0; lane < kWidth; ++lane)
+    {
+        const int laneIndex = (int)indices[lane];
+        if ((laneIndex >= 0) &&
+            ((dists[lane] < bestDistSq) || ((dists[lane] == bestDistSq) && (laneIndex < best))))
+        {
+            bestDistSq = dists[lane];
+            best = laneIndex;
+        }
+    }
+
+    best = findNearestFrom(packed, pos, nSimd, best, bestDistSq);
+    if (pDistSq && (best >= 0))
+        *pDistSq = bestDistSq;
+    return best;
+}
+
+void SpatialKernels::findAllWithin(const PackedPositions& packed, const Vec2& pos, float radius, FrameVector<Entity*>& result)
+{
+    const size_t n = packed.size();
+    const size_t nSimd = n - (n % kWidth);
+    const float radiusSq = radius * radius;
+
+    __m256 px = _mm256_set1_ps(pos.x);
+    __m256 py = _mm256_set1_ps(pos.y);
+    __m256 r2 = _mm256_set1_ps(radiusSq);
+
+    for (size_t i = 0; i < nSimd; i += kWidth)
+    {
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(distSq8(packed, i, px, py), r2, _CMP_LT_OQ));
+        for (size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+        {
+            if (mask & 1)
+                result.push_back(packed.m_Entities[i + lane]);
+        }
+    }
+
+    findAllFrom(packed, pos, radiusSq, nSimd, result);
+}
+
+bool SpatialKernels::anyWithinReach(const PackedPositions& packed, const Vec2& pos, float reach)
+{
+    const size_t n = packed.size();
+    const size_t nSimd = n - (n % kWidth);
+
+    __m256 px = _mm256_set1_ps(pos.x);
+    __m256 py = _mm256_set1_ps(pos.y);
+    __m256 vReach = _mm256_set1_ps(reach);
+
+    for (size_t i = 0; i < nSimd; i += kWidth)
+    {
+        __m256 r = _mm256_add_ps(vReach, _mm256_loadu_ps(&packed.m_HalfSize[i]));
+        __m256 within = _mm256_cmp_ps(distSq8(packed, i, px, py), _mm256_mul_ps(r, r), _CMP_LE_OQ);
+        if (_mm256_movemask_ps(within) != 0)
+            return true;
+    }
+
+    return anyWithinReachFrom(packed, pos, reach, nSimd);
+}
+
+#elif defined(SPATIAL_KERNELS_SSE)
+
+namespace
+{
+    const size_t kWidth = 4;
+
+    inline __m128 distSq4(const PackedPositions& packed, size_t i, __m128 px, __m128 py)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&packed.m_X[i]), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&packed.m_Y[i]), py);
+        return _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    }
+
+    // SSE2 has no blendv, so select with masks.
+    inline __m128 select4(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+    }
+}
+
+int SpatialKernels::findNearestWithin(const PackedPositions& packed, const Vec2& pos, float maxDistSq, float* pDistSq)
+{
+    const size_t n = packed.size();
+    const size_t nSimd = n - (n % kWidth);
+
+    __m128 px = _mm_set1_ps(pos.x);
+    __m128 py = _mm_set1_ps(pos.y);
+    __m128 bestDist = _mm_set1_ps(maxDistSq);
+    __m128 bestIndex = _mm_set1_ps(-1.f);
+    __m128 index = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+    const __m128 step = _mm_set1_ps((float)kWidth);
+
+    for (size_t i = 0; i < nSimd; i += kWidth)
+    {
+        __m128 d = distSq4(packed, i, px, py);
+        __m128 closer = _mm_cmplt_ps(d, bestDist);
+        bestDist = select4(closer, d, bestDist);
+        bestIndex = select4(closer, index, bestIndex);
+        index = _mm_add_ps(index, step);
+    }
+
+    float dists[kWidth];
+    float indices[kWidth];
+    _mm_storeu_ps(dists, bestDist);
+    _mm_storeu_ps(indices, bestIndex);
+
+    float bestDistSq = maxDistSq;
+    int best = -1;
+    for (size_t lane = 0; lane < kWidth; ++lane)
+    {
+        const int laneIndex = (int)indices[lane];
+        if ((laneIndex >= 0) &&
+            ((dists[lane] < bestDistSq) || ((dists[lane] == bestDistSq) && (laneIndex < best))))
+        {
+            bestDistSq = dists[lane];
+            best = laneIndex;
+        }
+    }
+
+    best = findNearestFrom(packed, pos, nSimd, best, bestDistSq);
+    if (pDistSq && (best >= 0))
+        *pDistSq = bestDistSq;
+    return best;
+}
+
+void SpatialKernels::findAllWithin(const PackedPositions& packed, const Vec2& pos, float radius, FrameVector<Entity*>& result)
+{
+    const size_t n = packed.size();
+    const size_t nSimd = n - (n % kWidth);
+    const float radiusSq = radius * radius;
+
+    __m128 px = _mm_set1_ps(pos.x);
+    __m128 py = _mm_set1_ps(pos.y);
+    __m128 r2 = _mm_set1_ps(radiusSq);
+
+    for (size_t i = 0; i < nSimd; i += kWidth)
+    {
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq4(packed, i, px, py), r2));
+        for (size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+        {
+            if (mask & 1)
+                result.push_back(packed.m_Entities[i + lane]);
+        }
+    }
+
+    findAllFrom(packed, pos, radiusSq, nSimd, result);
+}
+
+bool SpatialKernels::anyWithinReach(const PackedPositions& packed, const Vec2& pos, float reach)
+{
+    const size_t n = packed.size();
+    const size_t nSimd = n - (n % kWidth);
+
+    __m128 px = _mm_set1_ps(pos.x);
+    __m128 py = _mm_set1_ps(pos.y);
+    __m128 vReach = _mm_set1_ps(reach);
+
+    for (size_t i = 0; i < nSimd; i += kWidth)
+    {
+        __m128 r = _mm_add_ps(vReach, _mm_loadu_ps(&packed.m_HalfSize[i]));
+        __m128 within = _mm_cmple_ps(distSq4(packed, i, px, py), _mm_mul_ps(r, r));
+        if (_mm_movemask_ps(within) != 0)
+            return true;
+    }
+
+    return anyWithinReachFrom(packed, pos, reach, nSimd);
+}
+
+#else
+
+int SpatialKernels::findNearestWithin(const PackedPositions& packed, const Vec2& pos, float maxDistSq, float* pDistSq)
+{
+    return findNearestWithinScalar(packed, pos, maxDistSq, pDistSq);
+}
+
+void SpatialKernels::findAllWithin(const PackedPositions& packed, const Vec2& pos, float radius, FrameVector<Entity*>& result)
+{
+    findAllWithinScalar(packed, pos, radius, result);
+}
+
+bool SpatialKernels::anyWithinReach(const PackedPositions& packed, const Vec2& pos, float reach)
+{
+    return anyWithinReachScalar(packed, pos, reach);
+}
+
+#endif
@@ -0,0 +1,97 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "FrameArena.h"
+#include "Vec2.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class Entity;
+
+// The positions and half-sizes of a group of entities, stored as separate 
+// arrays so that the kernels below can test several entities at once.
+struct PackedPositions
+{
+    std::vector<float> m_X;
+    std::vector<float> m_Y;
+    std::vector<float> m_HalfSize;
+    std::vector<Entity*> m_Entities;    // NOT owned
+
+    size_t size() const { return m_Entities.size(); }
+
+    // Clearing keeps the memory, so repacking doesn't allocate once the 
+    // arrays have grown to fit.
+    void clear();
+    void add(Entity* pEntity);
+};
+
+// The entries of a PackedPositions bucketed by EventGrid cell, so that a 
+// radius query only has to look at the cells that the circle overlaps - and 
+// since the cells are stored a row at a time, that's one run of entries per
+// row.
+struct PackedCells
+{
+    std::vector<uint32_t> m_CellStart;  // where each cell's entries start in m_Indices, plus the end
+    std::vector<uint32_t> m_Indices;    // into the PackedPositions, grouped by cell
+
+    // Keeps the memory, like PackedPositions::clear()
+    void build(const PackedPositions& packed);
+};
+
+// Batch distance queries over PackedPositions.  They use AVX or SSE when the
+// compiler targets it (SSE is always there on x64), and plain loops when it
+// doesn't or when CRASHLOYAL_NO_SIMD is defined.  Every version returns
+// exactly what the plain loop would, including which entity wins a tie (the 
+// one packed first).
+namespace SpatialKernels
+{
+    // "avx", "sse" or "scalar"
+    const char* getInstructionSet();
+
+    // Returns the index of the closest entity whose squared distance from pos
+    // is strictly less than maxDistSq, or -1 if there isn't one.  If 
+    // pDistSq isn't NULL, the winner's squared distance is written to it.
+    int findNearestWithin(const PackedPositions& packed, const Vec2& pos, float maxDistSq, float* pDistSq = NULL);
+
+    // Appends every entity strictly within radius of pos, in packed order.
+    void findAllWithin(const PackedPositions& packed, const Vec2& pos, float radius, FrameVector<Entity*>& result);
+
+    // True if any entity is within reach of pos plus that entity's half-size
+    // (i.e. reach should already include the caller's half-size, for melee).
+    bool anyWithinReach(const PackedPositions& packed, const Vec2& pos, float reach);
+
+    // The same as findAllWithin(), but it only looks at the cells that could 
+    // hold something within radius, so the cost follows how many entities are
+    // near pos rather than how many there are.  The results are in cell order
+    // rather than packed order.  cells must have been built from packed.
+    void findAllWithinCells(const PackedPositions& packed, const PackedCells& cells, const Vec2& pos, float radius, FrameVector<Entity*>& result);
+
+    // The plain loops, always compiled, for platforms without SIMD and for
+    // checking the SIMD versions against.
+    int findNearestWithinScalar(const PackedPositions& packed, const Vec2& pos, float maxDistSq, float* pDistSq = NULL);
+    void findAllWithinScalar(const PackedPositions& packed, const Vec2& pos, float radius, FrameVector<Entity*>& result);
+    bool anyWithinReachScalar(const PackedPositions& packed, const Vec2& pos, float reach);
+}
@@ -0,0 +1,123 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "TickBudget.h"
+
+#include <assert.h>
+
+// A tick counts as comfortably under budget if it takes less than this 
+// fraction of it, and after this many of those in a row a fallback is turned
+// back off.  The gap between the two keeps a tick that's hovering around the
+// budget from flipping a fallback on and off every other tick.
+static const float kComfortableFraction = 0.6f;
+static const int kTicksToRecover = 40;
+
+TickBudget::TickBudget()
+    : m_BudgetMs(0.f)
+    , m_Level(0)
+    , m_NumTicksUnder(0)
+    , m_NumTicks(0)
+    , m_NumOverBudget(0)
+    , m_DroppedSec(0.0)
+{
+    for (int i = 0; i < NumFallbacks; ++i)
+    {
+        m_NumActivations[i] = 0;
+        m_NumTicksActive[i] = 0;
+    }
+}
+
+const char* TickBudget::getFallbackName(Fallback fallback)
+{
+    // NOTE: This must be kept in synch with the Fallback enum
+    static const char* sNames[NumFallbacks] =
+    {
+        "reuse_targets",
+        "defer_rogue_visibility",
+        "halve_collision_checks",
+        "throttle_controllers",
+    };
+
+    assert((fallback >= 0) && (fallback < NumFallbacks));
+    return sNames[fallback];
+}
+
+void TickBudget::setBudgetMs(float budgetMs)
+{
+    m_BudgetMs = (budgetMs > 0.f) ? budgetMs : 0.f;
+    if (!isEnabled())
+    {
+        m_Level = 0;
+    }
+    m_NumTicksUnder = 0;
+}
+
+void TickBudget::endTick(float tickMs)
+{
+    if (!isEnabled())
+        return;
+
+    ++m_NumTicks;
+    for (int i = 0; i < m_Level; ++i)
+    {
+        ++m_NumTicksActive[i];
+    }
+
+    if (tickMs > m_BudgetMs)
+    {
+        ++m_NumOverBudget;
+        m_NumTicksUnder = 0;
+        if (m_Level < NumFallbacks)
+        {
+            ++m_NumActivations[m_Level];
+            ++m_Level;
+        }
+    }
+    else if (tickMs < m_BudgetMs * kComfortableFraction)
+    {
+        if ((m_Level > 0) && (++m_NumTicksUnder >= kTicksToRecover))
+        {
+            --m_Level;
+            m_NumTicksUnder = 0;
+        }
+    }
+    else
+    {
+        m_NumTicksUnder = 0;
+    }
+}
+
+void TickBudget::writeReport(FILE* pFile) const
+{
+    if (!isEnabled())
+        return;
+
+    fprintf(pFile, "Tick budget %.1f ms: %llu of %llu ticks over, %.2f s of game time dropped\n",
+        m_BudgetMs, (unsigned long long)m_NumOverBudget, (unsigned long long)m_NumTicks, m_DroppedSec);
+    for (int i = 0; i < NumFallbacks; ++i)
+    {
+        fprintf(pFile, "    %-24s fired %8llu times, on for %10llu ticks\n",
+            getFallbackName((Fallback)i),
+            (unsigned long long)m_NumActivations[i],
+            (unsigned long long)m_NumTicksActive[i]);
+    }
+}
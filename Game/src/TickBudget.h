@@ -0,0 +1,90 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Keeps ticks inside a time budget by giving up a little quality when they
+// run over, rather than letting the game slow down (or, once a tick takes
+// longer than TICK_MAX, drop game time altogether).
+//
+// The fallbacks are ranked from least to most noticeable.  Each tick that 
+// goes over budget turns on the next one, and once ticks have been 
+// comfortably under budget for a while they're turned back off, most 
+// noticeable first.  The simulation code checks isActive() for each one.
+// NOTE: Whether a fallback fires depends on how fast the machine is, so 
+// monitoring is off unless a budget is set.  Headless and benchmark runs 
+// leave it off, so that they stay repeatable.
+class TickBudget
+{
+public:
+    enum Fallback
+    {
+        ReuseTargets,               // keep any target that's still alive and in sight
+        DeferRogueVisibility,       // Rogues only re-check whether they're hidden every few ticks
+        HalveCollisionChecks,       // each mob only checks for collisions every other tick
+        ThrottleControllers,        // each controller only thinks every other tick
+
+        NumFallbacks
+    };
+
+    TickBudget();
+
+    static const char* getFallbackName(Fallback fallback);
+
+    // 0 turns monitoring off (and all of the fallbacks with it)
+    void setBudgetMs(float budgetMs);
+    float getBudgetMs() const { return m_BudgetMs; }
+    bool isEnabled() const { return m_BudgetMs > 0.f; }
+
+    // Game calls this after every tick, with how long the tick took.
+    void endTick(float tickMs);
+
+    // How many fallbacks are on.  They're on for the whole of a tick, so 
+    // this is safe to read from the decide phase's jobs.
+    int getLevel() const { return m_Level; }
+    bool isActive(Fallback fallback) const { return (int)fallback < m_Level; }
+
+    // The game loop calls this when it has to throw game time away anyway
+    void addDroppedTime(float seconds) { m_DroppedSec += seconds; }
+
+    uint64_t getNumTicks() const { return m_NumTicks; }
+    uint64_t getNumOverBudget() const { return m_NumOverBudget; }
+    uint64_t getNumActivations(Fallback fallback) const { return m_NumActivations[fallback]; }
+    uint64_t getNumTicksActive(Fallback fallback) const { return m_NumTicksActive[fallback]; }
+    double getDroppedTime() const { return m_DroppedSec; }
+
+    void writeReport(FILE* pFile) const;
+
+private:
+    float m_BudgetMs;
+    int m_Level;
+    int m_NumTicksUnder;                    // in a row, comfortably under budget
+
+    uint64_t m_NumTicks;
+    uint64_t m_NumOverBudget;
+    uint64_t m_NumActivations[NumFallbacks];
+    uint64_t m_NumTicksActive[NumFallbacks];
+    double m_DroppedSec;
+};
@@ -0,0 +1,166 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "TimerWheel.h"
+
+#include <assert.h>
+#include <math.h>
+
+// Times that come from adding up float tick lengths pick up rounding error, so
+// anything due within this much of now counts as due.
+static const double kEpsilon = 1e-6;
+
+static const size_t kInitialBucketCapacity = 16;
+
+TimerWheel::TimerWheel(double resolution)
+    : m_Resolution(resolution)
+    , m_Now(0.0)
+    , m_CurrentSlot(0)
+    , m_NumTimers(0)
+{
+    assert(resolution > 0.0);
+
+    // Nearly everything (attack cooldowns in particular) lands on the finest
+    // level, so give its buckets a head start rather than having them all 
+    // grow during the first few seconds of a match.
+    for (int bucket = 0; bucket < kBucketsPerLevel; ++bucket)
+    {
+        m_Buckets[0][bucket].reserve(kInitialBucketCapacity);
+    }
+}
+
+uint64_t TimerWheel::toSlot(double time) const
+{
+    return (time <= 0.0) ? 0 : (uint64_t)floor(time / m_Resolution);
+}
+
+void TimerWheel::schedule(double dueTime, EntityHandle entity, int type, uint32_t data)
+{
+    Timer timer = { dueTime, entity, type, data };
+    insert(timer);
+    ++m_NumTimers;
+}
+
+void TimerWheel::insert(const Timer& timer)
+{
+    // Round the slot down, so that a timer's bucket is always reached by the
+    // time it's due (give or take kEpsilon).
+    uint64_t slot = toSlot(timer.m_DueTime - kEpsilon);
+    if (slot < m_CurrentSlot)
+        slot = m_CurrentSlot;
+
+    // Timers too far out for the top level wait in its last bucket, and get
+    // sorted out when they're cascaded.
+    const uint64_t kMaxDelta = (1ull << (kBitsPerLevel * kNumLevels)) - 1;
+    uint64_t delta = slot - m_CurrentSlot;
+    if (delta > kMaxDelta)
+    {
+        slot = m_CurrentSlot + kMaxDelta;
+        delta = kMaxDelta;
+    }
+
+    int level = 0;
+    while ((level < kNumLevels - 1) && (delta >= (1ull << (kBitsPerLevel * (level + 1)))))
+    {
+        ++level;
+    }
+
+    const int bucket = (int)((slot >> (kBitsPerLevel * level)) & (kBucketsPerLevel - 1));
+    m_Buckets[level][bucket].push_back(timer);
+}
+
+void TimerWheel::advance(double now, std::vector<Timer>& fired)
+{
+    assert(now >= m_Now);
+    const uint64_t targetSlot = toSlot(now);
+
+    // The current slot can hold timers that weren't quite due last time
+    fireBucket(m_Buckets[0][m_CurrentSlot & (kBucketsPerLevel - 1)], now, fired);
+
+    while (m_CurrentSlot < targetSlot)
+    {
+        ++m_CurrentSlot;
+
+        // Going from the top down, pull in any bucket that time just reached,
+        // so that its timers land in the levels below before those are checked.
+        for (int level = kNumLevels - 1; level > 0; --level)
+        {
+            const uint64_t lowBits = (1ull << (kBitsPerLevel * level)) - 1;
+            if ((m_CurrentSlot & lowBits) == 0)
+            {
+                cascade(level);
+            }
+        }
+
+        fireBucket(m_Buckets[0][m_CurrentSlot & (kBucketsPerLevel - 1)], now, fired);
+    }
+
+    m_Now = now;
+}
+
+void TimerWheel::fireBucket(std::vector<Timer>& bucket, double now, std::vector<Timer>& fired)
+{
+    size_t numKept = 0;
+    for (size_t i = 0; i < bucket.size(); ++i)
+    {
+        if (bucket[i].m_DueTime <= now + kEpsilon)
+        {
+            fired.push_back(bucket[i]);
+            --m_NumTimers;
+        }
+        else
+        {
+            bucket[numKept++] = bucket[i];
+        }
+    }
+    bucket.resize(numKept);
+}
+
+void TimerWheel::cascade(int level)
+{
+    std::vector<Timer>& bucket = m_Buckets[level][(m_CurrentSlot >> (kBitsPerLevel * level)) & (kBucketsPerLevel - 1)];
+
+    // Copy the bucket out first, since its timers could land back in it.  
+    // (Copying rather than swapping leaves each bucket with the memory it has
+    // grown into.)
+    m_Cascading.assign(bucket.begin(), bucket.end());
+    bucket.clear();
+    for (const Timer& timer : m_Cascading)
+    {
+        insert(timer);
+    }
+}
+
+void TimerWheel::clear()
+{
+    for (int level = 0; level < kNumLevels; ++level)
+    {
+        for (int bucket = 0; bucket < kBucketsPerLevel; ++bucket)
+        {
+            m_Buckets[level][bucket].clear();
+        }
+    }
+
+    m_Now = 0.0;
+    m_CurrentSlot = 0;
+    m_NumTimers = 0;
+}
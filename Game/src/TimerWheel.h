@@ -0,0 +1,89 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EntityHandle.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Schedules timed events in simulation time, so that an entity waiting on a 
+// cooldown costs nothing until the cooldown is up, rather than counting down
+// every tick.
+//
+// This is a hierarchical timing wheel.  Time is cut into slots, and the 
+// finest level has one bucket per slot for the next 64 slots.  Each level up 
+// has buckets 64 times as wide.  A timer goes into the finest level that can
+// hold it, and is moved down a level ("cascaded") when time reaches its 
+// bucket.  So scheduling is O(1), and advancing only touches the buckets that
+// time passes through.
+class TimerWheel
+{
+public:
+    struct Timer
+    {
+        double m_DueTime;
+        EntityHandle m_Entity;
+        int m_Type;                 // up to the entity
+        uint32_t m_Data;            // also up to the entity
+    };
+
+    // resolution is the width of a slot on the finest level, in seconds
+    explicit TimerWheel(double resolution);
+
+    double getTime() const { return m_Now; }
+    size_t size() const { return m_NumTimers; }
+
+    // Timers that are already due will fire on the next advance().
+    void schedule(double dueTime, EntityHandle entity, int type, uint32_t data = 0);
+
+    // Moves time forward to now, and appends every timer that's due to fired.
+    // Timers that are due in the same slot fire in the order they were 
+    // scheduled.
+    void advance(double now, std::vector<Timer>& fired);
+
+    // Drops every timer and sets the time back to 0.
+    void clear();
+
+private:
+    static const int kBitsPerLevel = 6;
+    static const int kBucketsPerLevel = 1 << kBitsPerLevel;
+    static const int kNumLevels = 4;
+
+    uint64_t toSlot(double time) const;
+    void insert(const Timer& timer);
+    void fireBucket(std::vector<Timer>& bucket, double now, std::vector<Timer>& fired);
+    void cascade(int level);
+
+private:
+    double m_Resolution;
+    double m_Now;
+    uint64_t m_CurrentSlot;
+    size_t m_NumTimers;
+
+    // NOTE: The buckets are cleared rather than freed, so once they've grown
+    // to fit scheduling doesn't allocate.
+    std::vector<Timer> m_Buckets[kNumLevels][kBucketsPerLevel];
+    std::vector<Timer> m_Cascading;
+};
@@ -67,6 +67,10 @@ const float WAYPOINT_Y_INCREMENT = 2.f;
 const float TICK_MIN = 0.05f;
 const float TICK_MAX = 0.2f;
 
+// Frame pacing (used when vsync isn't available)
+const float FRAME_TIME = 1.f / 60.f;
+const int IDLE_WAIT_MS = 250;     // how long to wait for events when nothing is changing
+
 // Elixir
 
 const float STARTING_ELIXIR = 8.f;
@@ -75,3 +79,14 @@ const float MAX_ELIXIR = 10.01f; // a little bit more than 10, to avoid float er
 
 
 
+
+// Projectiles
+const float PROJECTILE_SPEED = 12.f; // tiles per second, for Ranged attacks
+const float PROJECTILE_SIZE = 0.2f; // how big they're drawn, in tiles
+const int MAX_PROJECTILES = 4096; // how many can be in flight at once, per match
+
+// Sleeping
+const float MOB_SLEEP_MARGIN = 1.f; // slack on how near things can be before a mob has to stay awake
+
+// Rogue
+const float ROGUE_HIDE_TIME = 2.f; // how long a Rogue has to stay hidden before it turns invisible and can spring
@@ -0,0 +1,95 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// A compact, generation-checked reference to an entity.  The low bits hold the
+// index of the entity's slot in the registry, and the high bits hold the
+// generation of that slot at the time the handle was made.  When an entity is
+// freed its slot's generation is bumped, so any handles still pointing at it
+// become stale and resolve to NULL instead of to freed (or reused) memory.
+class EntityHandle
+{
+public:
+    static const uint32_t kIndexBits = 20;
+    static const uint32_t kGenerationBits = 32 - kIndexBits;
+    static const uint32_t kMaxIndex = (1u << kIndexBits) - 1;
+    static const uint32_t kMaxGeneration = (1u << kGenerationBits) - 1;
+
+    // The default handle is the null handle.  Generation 0 is never handed out,
+    // so a null handle never resolves to a live entity.
+    EntityHandle() : m_Value(0) {}
+    EntityHandle(uint32_t index, uint32_t generation)
+        : m_Value((generation << kIndexBits) | (index & kMaxIndex))
+    {
+    }
+
+    uint32_t getIndex() const { return m_Value & kMaxIndex; }
+    uint32_t getGeneration() const { return m_Value >> kIndexBits; }
+    uint32_t getValue() const { return m_Value; }
+
+    bool isNull() const { return m_Value == 0; }
+
+    bool operator==(const EntityHandle& rhs) const { return m_Value == rhs.m_Value; }
+    bool operator!=(const EntityHandle& rhs) const { return m_Value != rhs.m_Value; }
+
+private:
+    uint32_t m_Value;
+};
+
+// A flat set of entity handles, indexed directly by slot.  Membership tests are
+// O(1), and because the full handle is stored, a slot that has been recycled 
+// for a new entity is not mistaken for the old one that was inserted.
+class EntityHandleSet
+{
+public:
+    void insert(EntityHandle h)
+    {
+        if (h.isNull()) return;
+        if (h.getIndex() >= m_Slots.size())
+        {
+            m_Slots.resize(h.getIndex() + 1);
+        }
+        m_Slots[h.getIndex()] = h;
+    }
+
+    void erase(EntityHandle h)
+    {
+        if (contains(h))
+        {
+            m_Slots[h.getIndex()] = EntityHandle();
+        }
+    }
+
+    bool contains(EntityHandle h) const
+    {
+        return !h.isNull() && (h.getIndex() < m_Slots.size()) && (m_Slots[h.getIndex()] == h);
+    }
+
+    void clear() { m_Slots.clear(); }
+
+private:
+    std::vector<EntityHandle> m_Slots;
+};
@@ -0,0 +1,123 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+FrameArena::FrameArena(size_t initialBytes)
+    : m_pCurrent(NULL)
+    , m_pEnd(NULL)
+    , m_BytesUsed(0)
+    , m_HighWater(0)
+{
+    addBlock(initialBytes);
+}
+
+FrameArena::~FrameArena()
+{
+    for (Block& block : m_Blocks)
+    {
+        free(block.m_pData);
+    }
+}
+
+FrameArena& FrameArena::getThreadArena()
+{
+    static thread_local FrameArena sArena;
+    return sArena;
+}
+
+void* FrameArena::allocate(size_t numBytes, size_t alignment)
+{
+    assert((alignment > 0) && ((alignment & (alignment - 1)) == 0));
+
+    uintptr_t current = (uintptr_t)m_pCurrent;
+    uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (aligned + numBytes > (uintptr_t)m_pEnd)
+    {
+        addBlock(numBytes + alignment);
+        current = (uintptr_t)m_pCurrent;
+        aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+
+    m_pCurrent = (char*)(aligned + numBytes);
+    m_BytesUsed += (aligned - current) + numBytes;
+    m_HighWater = std::max(m_HighWater, m_BytesUsed);
+    return (void*)aligned;
+}
+
+void FrameArena::reset()
+{
+    // If last tick needed more than one block, swap them all for one block
+    // that would have held everything.
+    if (m_Blocks.size() > 1)
+    {
+        size_t capacity = getCapacity();
+        for (Block& block : m_Blocks)
+        {
+            free(block.m_pData);
+        }
+        m_Blocks.clear();
+        addBlock(capacity);
+    }
+
+#ifndef NDEBUG
+    // Make anything that hung on to scratch data from last tick fail loudly
+    memset(m_Blocks[0].m_pData, 0xCD, m_pCurrent - m_Blocks[0].m_pData);
+#endif
+
+    m_pCurrent = m_Blocks[0].m_pData;
+    m_pEnd = m_pCurrent + m_Blocks[0].m_Size;
+    m_BytesUsed = 0;
+}
+
+size_t FrameArena::getCapacity() const
+{
+    size_t total = 0;
+    for (const Block& block : m_Blocks)
+    {
+        total += block.m_Size;
+    }
+    return total;
+}
+
+void FrameArena::addBlock(size_t minBytes)
+{
+    // Each new block at least doubles what we have, so a tick that keeps on
+    // allocating only adds a handful of blocks.
+    size_t size = std::max(minBytes, getCapacity());
+    size = std::max(size, (size_t)4096);
+
+    Block block;
+    block.m_pData = (char*)malloc(size);
+    block.m_Size = size;
+    assert(block.m_pData);
+    m_Blocks.push_back(block);
+
+    m_pCurrent = block.m_pData;
+    m_pEnd = block.m_pData + size;
+}
@@ -0,0 +1,105 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+// A bump allocator for scratch data that only lives for a single tick.  
+// Allocating is a pointer bump, freeing does nothing, and reset() throws the
+// whole lot away at once.  Game::tick() resets the simulation thread's arena
+// at the start of every tick, so nothing allocated from it may be kept past 
+// the end of the tick that allocated it.
+//
+// Memory comes in blocks.  When a tick overflows the current block another is
+// chained on, and on the next reset() the blocks are merged into one that is
+// big enough for the whole tick - so after the first few ticks there's a 
+// single block and reset() is O(1).
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t initialBytes = 64 * 1024);
+    ~FrameArena();
+
+    // Each thread has its own arena.  Use this rather than making your own.
+    static FrameArena& getThreadArena();
+
+    void* allocate(size_t numBytes, size_t alignment);
+    void reset();
+
+    size_t getBytesUsed() const { return m_BytesUsed; }
+    size_t getHighWater() const { return m_HighWater; }
+    size_t getCapacity() const;
+
+private:
+    struct Block
+    {
+        char* m_pData;
+        size_t m_Size;
+    };
+
+    void addBlock(size_t minBytes);
+
+    std::vector<Block> m_Blocks;
+    char* m_pCurrent;
+    char* m_pEnd;
+    size_t m_BytesUsed;             // since the last reset, including padding
+    size_t m_HighWater;             // most bytes used in any one tick
+
+private:
+    // DELIBERATELY UNDEFINED
+    FrameArena(const FrameArena& rhs);
+    FrameArena& operator=(const FrameArena& rhs);
+};
+
+// An STL allocator that allocates from the calling thread's FrameArena, so 
+// containers built on it are only good until the end of the tick.
+template<class T>
+class FrameAllocator
+{
+public:
+    typedef T value_type;
+
+    FrameAllocator() : m_pArena(&FrameArena::getThreadArena()) {}
+    template<class U>
+    FrameAllocator(const FrameAllocator<U>& rhs) : m_pArena(rhs.getArena()) {}
+
+    T* allocate(size_t n) { return (T*)m_pArena->allocate(n * sizeof(T), alignof(T)); }
+    void deallocate(T*, size_t) {}
+
+    FrameArena* getArena() const { return m_pArena; }
+
+    template<class U>
+    bool operator==(const FrameAllocator<U>& rhs) const { return m_pArena == rhs.getArena(); }
+    template<class U>
+    bool operator!=(const FrameAllocator<U>& rhs) const { return m_pArena != rhs.getArena(); }
+
+private:
+    FrameArena* m_pArena;
+};
+
+// A vector of per-tick scratch data.  NOTE: Don't keep one past the end of
+// the tick, and don't return one from anything that may be called outside of
+// a tick unless the caller is done with it before the next tick starts.
+template<class T>
+using FrameVector = std::vector<T, FrameAllocator<T> >;
@@ -43,7 +43,12 @@ protected:
         s_Obj = (T*)this; 
     }
 
-    virtual ~Singleton() {}
+    virtual ~Singleton()
+    {
+        // Don't leave get() handing out a deleted object
+        if (static_cast<Singleton*>(s_Obj) == this)
+            s_Obj = NULL;
+    }
 
 public:
     static T& get() 
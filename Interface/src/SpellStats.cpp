@@ -0,0 +1,106 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SpellStats.h"
+
+#include <float.h>
+#include <stddef.h>
+#include <vector>
+
+class SpellStats_Fireball : public iSpellStats
+{
+public:
+    virtual SpellType getSpellType() const { return Fireball; }
+    virtual float getElixirCost() const { return 4.f; }
+    virtual float getRadius() const { return 2.5f; }
+    virtual float getDuration() const { return 0.f; }
+    virtual int getDamage() const { return 572; }
+    virtual float getPullSpeed() const { return 0.f; }
+    virtual float getHasteMultiplier() const { return 1.f; }
+    virtual float getHasteLingerTime() const { return 0.f; }
+    virtual const char* getName() const { return "Fireball"; }
+};
+
+class SpellStats_Tornado : public iSpellStats
+{
+public:
+    virtual SpellType getSpellType() const { return Tornado; }
+    virtual float getElixirCost() const { return 3.f; }
+    virtual float getRadius() const { return 3.f; }
+    virtual float getDuration() const { return 1.5f; }
+    virtual int getDamage() const { return 0; }
+    virtual float getPullSpeed() const { return 3.f; }
+    virtual float getHasteMultiplier() const { return 1.f; }
+    virtual float getHasteLingerTime() const { return 0.f; }
+    virtual const char* getName() const { return "Tornado"; }
+};
+
+class SpellStats_Haste : public iSpellStats
+{
+public:
+    virtual SpellType getSpellType() const { return Haste; }
+    virtual float getElixirCost() const { return 2.f; }
+    virtual float getRadius() const { return 3.f; }
+    virtual float getDuration() const { return 6.f; }
+    virtual int getDamage() const { return 0; }
+    virtual float getPullSpeed() const { return 0.f; }
+    virtual float getHasteMultiplier() const { return 1.35f; }
+    virtual float getHasteLingerTime() const { return 2.f; }
+    virtual const char* getName() const { return "Haste"; }
+};
+
+class SpellStats_Invalid : public iSpellStats
+{
+public:
+    virtual SpellType getSpellType() const { return InvalidSpellType; }
+    virtual float getElixirCost() const { return FLT_MAX; }
+    virtual float getRadius() const { return 0.f; }
+    virtual float getDuration() const { return 0.f; }
+    virtual int getDamage() const { return 0; }
+    virtual float getPullSpeed() const { return 0.f; }
+    virtual float getHasteMultiplier() const { return 1.f; }
+    virtual float getHasteLingerTime() const { return 0.f; }
+    virtual const char* getName() const { return "Invalid"; }
+};
+
+const iSpellStats& iSpellStats::getStats(SpellType t)
+{
+    // NOTE: This vector must be in synch with the SpellType enum (in the .h)
+    static std::vector<const iSpellStats*> sStats = {
+        new SpellStats_Fireball,
+        new SpellStats_Tornado,
+        new SpellStats_Haste
+    };
+
+    // If any of these fail, then your vector (above) is out of synch with the 
+    //  SpellType enum (in the .h)... and bad things may ensue!
+    assert(sStats.size() == numSpellTypes);
+
+    if ((size_t)t < sStats.size())
+    {
+        assert(sStats[t]->getSpellType() == t);
+        return *sStats[t];
+    }
+
+    static const SpellStats_Invalid ksInvalidStats;
+    return ksInvalidStats;
+}
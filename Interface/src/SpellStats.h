@@ -0,0 +1,72 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Final Project: The interface in this file lets your AI find out what spells
+// exist and what each one does.  The actual values are in SpellStats.cpp.
+// Cast them with iPlayer::castSpell().
+
+#include <assert.h>
+
+// Stats that each spell needs to have.  A spell covers a circle of 
+// getRadius() around where it was cast, for getDuration() seconds, and does
+// any or all of: damaging the enemies in it when it lands, pulling enemy mobs 
+// toward its center, and hasting your own mobs.
+class iSpellStats
+{
+public:
+    // NOTE: This enum must be in synch with the vector in iSpellStats::getStats()
+    enum SpellType
+    {
+        Fireball,
+        Tornado,
+        Haste,
+
+        numSpellTypes,
+
+        InvalidSpellType
+    };
+
+    static const iSpellStats& getStats(SpellType t);
+
+    virtual SpellType getSpellType() const = 0;
+    virtual float getElixirCost() const = 0;
+    virtual float getRadius() const = 0;
+
+    // How long the spell lasts.  0 means that it's all over in the tick that
+    // it's cast.
+    virtual float getDuration() const = 0;
+
+    // Dealt once, when the spell lands, to every enemy mob and building in it
+    virtual int getDamage() const = 0;
+
+    // Tiles per second that enemy mobs in the area are pulled toward its center
+    virtual float getPullSpeed() const = 0;
+
+    // Your own mobs in the area move and attack this many times as fast, until
+    // getHasteLingerTime() after they were last in it.  1 means no haste.
+    virtual float getHasteMultiplier() const = 0;
+    virtual float getHasteLingerTime() const = 0;
+
+    virtual const char* getName() const = 0;
+};
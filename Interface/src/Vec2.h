@@ -25,6 +25,7 @@
 #include <cmath>
 #include <iostream>
 #include <stdio.h>
+#include <type_traits>
 
 class Vec2 {
 public:
@@ -34,13 +35,10 @@ public:
     Vec2() : x(-FLT_MAX), y(-FLT_MAX) {}
     Vec2(int inX, int inY) : x((float)inX), y((float)inY) {}
     Vec2(float inX, float inY) : x(inX), y(inY) {}
-    Vec2(const Vec2& rhs) : x(rhs.x), y(rhs.y) {}
 
     bool operator==(const Vec2& rhs) const { return (x == rhs.x) && (y == rhs.y); }
     bool operator!=(const Vec2& rhs) const { return (x != rhs.x) || (y != rhs.y); }
 
-    Vec2& operator=(const Vec2& rhs) { x = rhs.x; y = rhs.y; return *this; }
-
     Vec2 operator+(const Vec2& rhs) const { return Vec2(x + rhs.x, y + rhs.y); }
     Vec2& operator+=(const Vec2& rhs) { x += rhs.x; y += rhs.y; return *this; }
 
@@ -73,3 +71,6 @@ private:
     bool operator<(const Vec2& rhs) const;
 };
 
+// NOTE: Vec2 deliberately uses the compiler's copy constructor and assignment,
+// so that it can be memcpy'd and packed into arrays for the batch kernels.
+static_assert(std::is_trivially_copyable<Vec2>::value, "Vec2 must stay trivially copyable");
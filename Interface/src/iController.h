@@ -46,7 +46,14 @@ public:
     // Final Project: This is where you will do most of your work.  This is 
     // called as part of the game loop.  deltaTSec is the elapsed time (in
     // seconds, and in game time) since the last tick.
-    virtual void tick(float deltaTSec, const std::vector<Entity *> allyMobs, const std::vector<Entity *> enemyMobs) = 0;
+    virtual void tick(float deltaTSec, const std::vector<Entity *>& allyMobs, const std::vector<Entity *>& enemyMobs) = 0;
+
+    // Headless runs skip straight over stretches where the board is empty.
+    // Return how many of the coming ticks you're sure to do nothing in if 
+    // nothing is placed; the game may then call skipTicks() instead of tick()
+    // for up to that many.  The default of 0 never lets the game skip.
+    virtual int getIdleTicks() const { return 0; }
+    virtual void skipTicks(int numTicks) { assert(numTicks <= getIdleTicks()); }
 
 protected:
     iPlayer* m_pPlayer; // NOT owned, guaranteed to exist when tick() is called
@@ -29,14 +29,16 @@ iPlayer::EntityData::EntityData()
     : m_Stats(iEntityStats::getStats(iEntityStats::InvalidMobType))
     , m_Health(INT_MIN)
     , m_Position(ksInvalidPos)
+    , m_Handle()
 {
 }
 
-iPlayer::EntityData::EntityData(const iEntityStats& stats, const int& health, const Vec2& pos)
+iPlayer::EntityData::EntityData(const iEntityStats& stats, int health, const Vec2& pos, EntityHandle handle)
 
     : m_Stats(stats)
     , m_Health(health)
     , m_Position(pos)
+    , m_Handle(handle)
 {
 }
 
@@ -44,6 +46,7 @@ iPlayer::EntityData::EntityData(const EntityData& rhs)
     : m_Stats(rhs.m_Stats)
     , m_Health(rhs.m_Health)
     , m_Position(rhs.m_Position)
+    , m_Handle(rhs.m_Handle)
 {
 }
 
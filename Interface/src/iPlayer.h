@@ -27,7 +27,9 @@
 // query into the state of your player and the opposing player, and to control 
 // your player.
 
+#include "EntityHandle.h"
 #include "EntityStats.h"
+#include "SpellStats.h"
 #include "Vec2.h"
 #include <vector>
 
@@ -64,21 +66,33 @@ public:
         InvalidX,
         InvalidY,
         MobTypeUnavailable,
+        SpellTypeUnavailable,
     };
     virtual PlacementResult placeMob(iEntityStats::MobType type, const Vec2& pos) = 0;
 
+    // Final Project: Spells work like mobs, except that they can be cast 
+    // anywhere in the arena (on either side of the river), and they're 
+    // centered exactly where you cast them rather than on a tile.  See 
+    // SpellStats.h for what each one does.
+    virtual const std::vector<iSpellStats::SpellType>& GetAvailableSpellTypes() const = 0;
+    virtual PlacementResult castSpell(iSpellStats::SpellType type, const Vec2& pos) = 0;
+
     // Final Project: Use these interfaces to get data about your own entities and/or
     // the opposing player's entities.
     // NOTE: When getting buildings or mobs, you are responsible for ensuring you pass
     // in a valid index, but if you don't I'll create an invalid one for you.
+    // EntityData is a copy of the entity's state at the time you asked for it - 
+    // hang on to m_Handle (not the data) if you want to find the entity again 
+    // on a later tick.
     struct EntityData
     {
         const iEntityStats& m_Stats;
-        const int& m_Health;
-        const Vec2& m_Position;
+        int m_Health;
+        Vec2 m_Position;
+        EntityHandle m_Handle;
 
         EntityData();
-        EntityData(const iEntityStats& stats, const int& health, const Vec2& pos);
+        EntityData(const iEntityStats& stats, int health, const Vec2& pos, EntityHandle handle);
         EntityData(const EntityData& rhs);
     };
 
@@ -92,6 +106,11 @@ public:
     virtual unsigned int getNumOpponentMobs() const = 0;
     virtual EntityData getOpponentMob(unsigned int i) const = 0;
 
+    // Final Project: Looks up any entity (yours or your opponent's) by handle.
+    // If the entity has died since you got the handle, you'll get back invalid
+    // data (m_Handle will be null).
+    virtual EntityData getEntity(EntityHandle h) const = 0;
+
 private:
     // DELIBERATELY UNDEFINED
     iPlayer(const iPlayer& rhs);